@@ -0,0 +1,32 @@
+#include <cmath>
+#include <femtool.hpp>
+
+// Check of the boundary mass matrix: (B 1|1) must be equal to the
+// measure of the boundary of [0,1]^d, i.e. 2 points, 4 edges, 6 faces.
+
+template <std::size_t DIM>
+void Check(const Mesh<DIM>& Omega, const double& exact){
+
+  auto Vh   = FeSpace(Omega);
+  auto B    = BoundaryMass(Vh);
+  std::vector<double> one(dim(Vh),1.);
+
+  // Same thing, added directly into a CSR pattern
+  auto A    = Pattern(Vh);
+  AddBoundaryMass(A,Vh,1.);
+
+  std::cout << "DIM = " << DIM << ": ";
+  std::cout << "(B 1|1) = " << (B(one)|one) << ", ";
+  std::cout << "(A 1|1) = " << (A(one)|one) << ", ";
+  std::cout << "boundary measure = " << exact << "\n";
+  assert(std::abs((B(one)|one)-exact)<1e-12*exact);
+  assert(std::abs((A(one)|one)-exact)<1e-12*exact);
+}
+
+int main(){
+
+  Check(Segment(4),      2.);
+  Check(Rectangle(8,5),  4.);
+  Check(Box(4,3,5),      6.);
+
+}
@@ -0,0 +1,585 @@
+#ifndef CHOLESKY_HPP
+#define CHOLESKY_HPP
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <atomic>
+#include <assert.h>
+#include <Eigen/Sparse>
+#include "parallel.hpp"
+#include "ordering.hpp"
+
+//############################//
+//  Cholesky multifrontale    //
+//############################//
+
+// Factorisation P A P^T = L L^T d'une matrice symetrique definie
+// positive, stockee en entier (triangles inferieur et superieur).
+//  - analyse: renumerotation (dissection emboitee par defaut), arbre
+//    d'elimination post-ordonne, supernoeuds fondamentaux, structure
+//    des lignes de L et tables de correspondance pour l'assemblage;
+//  - factorisation: chaque supernoeud forme une matrice frontale
+//    dense (coefficients de A + contributions des fils), dont les
+//    premieres colonnes sont factorisees par blocs, le complement de
+//    Schur etant transmis au pere. Les supernoeuds d'un meme niveau
+//    de l'arbre sont traites en parallele; lorsqu'il en reste moins
+//    que de threads, ce sont les mises a jour denses qui le sont.
+// L'interface (analyzePattern, factorize, info, solve) est celle des
+// solveurs d'Eigen, ce qui permet de l'utiliser dans InvCooMatrix.
+template <typename VALUE_TYPE = double>
+class SupernodalCholesky{
+
+public:
+
+  using ValueType       = VALUE_TYPE;
+  using EigenMatrixType = Eigen::SparseMatrix<ValueType>;
+  using IndexContainer  = std::vector<std::size_t>;
+  using ValueContainer  = std::vector<ValueType>;
+
+  static_assert(std::is_floating_point_v<ValueType>);
+  static constexpr std::size_t npos  = std::numeric_limits<std::size_t>::max();
+  static constexpr std::size_t block = 64;
+
+  SupernodalCholesky(const OrderingType& ordering0 = OrderingType::NestedDissection):
+    ordering(ordering0) {};
+
+  template <typename OtherValueType>
+  SupernodalCholesky(const Eigen::SparseMatrix<OtherValueType>& A,
+		     const OrderingType& ordering0 = OrderingType::NestedDissection):
+    ordering(ordering0) {analyzePattern(A); factorize(A);}
+
+  std::size_t rows() const {return n;}
+  std::size_t cols() const {return n;}
+
+  Eigen::ComputationInfo info() const {return status;}
+
+  // Nombre de coefficients de L et de supernoeuds
+  std::size_t nonZeros() const {return lptr.empty() ? 0 : lptr.back();}
+  std::size_t supernodes() const {return nsup;}
+
+  // Operations de la factorisation numerique (zeros stockes compris)
+  double flops() const {
+    double fl = 0.;
+    for(std::size_t s=0; s<nsup; ++s){
+      const double ns = rptr[s+1]-rptr[s];
+      for(std::size_t j=0; j<sfirst[s+1]-sfirst[s]; ++j){
+	fl += (ns-j)*(ns-j);}
+    }
+    return fl;
+  }
+
+  // Octets conserves entre factorisations (facteur et analyse)
+  std::size_t memory() const {
+    const std::size_t ni =
+      perm.size()+iperm.size()+parent.size()+count.size()+
+      sfirst.size()+snode.size()+sparent.size()+cptr.size()+
+      child.size()+rptr.size()+row.size()+lptr.size()+aptr.size()+
+      apos.size()+aval.size()+uptr.size()+relind.size();
+    return ni*sizeof(std::size_t)+lval.size()*sizeof(ValueType);
+  }
+
+  // Octets de travail au plus fort de la factorisation: matrices
+  // frontales en cours et complements de Schur en attente du pere
+  std::size_t workspace() const {
+    std::size_t live = 0, peak = 0;
+    for(const auto& lvl:level){
+      std::vector<std::size_t> f;
+      for(const auto& s:lvl){
+	const std::size_t ns = rptr[s+1]-rptr[s];
+	const std::size_t m  = ns-(sfirst[s+1]-sfirst[s]);
+	f.push_back(ns*ns);
+	live += m*m;}
+      std::sort(f.rbegin(),f.rend());
+      f.resize(std::min(f.size(),NbThread()));
+      peak = std::max(peak,live+std::accumulate(f.begin(),f.end(),std::size_t(0)));
+      for(const auto& s:lvl){
+	for(std::size_t c=cptr[s]; c<cptr[s+1]; ++c){
+	  const std::size_t m = uptr[child[c]+1]-uptr[child[c]];
+	  live -= m*m;}}
+    }
+    return peak*sizeof(ValueType);
+  }
+
+  //############################//
+  //    Analyse symbolique      //
+  //############################//
+
+  template <typename OtherValueType>
+  void analyzePattern(const Eigen::SparseMatrix<OtherValueType>& A){
+
+    assert(A.rows()==A.cols());
+    n = A.rows();
+    status = Eigen::Success;
+
+    // Renumerotation, puis post-ordre de l'arbre d'elimination
+    perm = Ordering(Adjacency(A),
+		    ordering==OrderingType::GeometricNestedDissection ?
+		    OrderingType::NestedDissection : ordering);
+    Invert();
+    EliminationTree(A);
+    auto post = PostOrder();
+    IndexContainer p(n);
+    for(std::size_t j=0; j<n; ++j){p[j] = perm[post[j]];}
+    perm.swap(p);
+    Invert();
+    EliminationTree(A);
+
+    ColumnCounts(A);
+    Supernodes();
+    RowStructure(A);
+    Levels();
+  }
+
+  //############################//
+  //  Factorisation numerique   //
+  //############################//
+
+  template <typename OtherValueType>
+  void factorize(const Eigen::SparseMatrix<OtherValueType>& A){
+
+    assert(std::size_t(A.rows())==n && std::size_t(A.nonZeros())==nnzA);
+    const OtherValueType* a = A.valuePtr();
+    lval.assign(lptr.back(),ValueType(0));
+    std::vector<ValueContainer> update(nsup);
+    std::vector<ValueContainer> front(NbThread());
+    std::atomic<bool> ok = true;
+
+    auto work = [&](const std::size_t& s, const std::size_t& t,
+		    const bool& inner){
+      const std::size_t ns = rptr[s+1]-rptr[s];
+      const std::size_t nc = sfirst[s+1]-sfirst[s];
+      auto& F = front[t];
+      F.assign(ns*ns,ValueType(0));
+
+      // Coefficients de A
+      for(std::size_t q=aptr[s]; q<aptr[s+1]; ++q){
+	F[apos[q]] += ValueType(a[aval[q]]);}
+
+      // Contributions des fils (extend-add)
+      for(std::size_t c=cptr[s]; c<cptr[s+1]; ++c){
+	const std::size_t  sc = child[c];
+	const std::size_t  mc = rptr[sc+1]-rptr[sc]-(sfirst[sc+1]-sfirst[sc]);
+	const std::size_t* ri = relind.data()+uptr[sc];
+	const auto& U = update[sc];
+	for(std::size_t k=0; k<mc; ++k){
+	  ValueType* Fk = F.data()+ri[k]*ns;
+	  for(std::size_t i=k; i<mc; ++i){Fk[ri[i]] += U[i+k*mc];}}
+	ValueContainer().swap(update[sc]);
+      }
+
+      if(!PartialCholesky(F.data(),ns,nc,inner)){ok = false; return;}
+
+      std::copy(F.begin(),F.begin()+ns*nc,lval.begin()+lptr[s]);
+      const std::size_t m = ns-nc;
+      auto& U = update[s];
+      U.resize(m*m);
+      for(std::size_t k=0; k<m; ++k){
+	for(std::size_t i=k; i<m; ++i){
+	  U[i+k*m] = F[(nc+i)+(nc+k)*ns];}}
+    };
+
+    for(const auto& lvl:level){
+      if(!ok){break;}
+      if(lvl.size()>=NbThread()){
+	ParallelTasks(lvl.size(),[&](const std::size_t& j, const std::size_t& t){
+	  work(lvl[j],t,false);});}
+      else{
+	for(const auto& s:lvl){work(s,0,true);}}
+    }
+    status = ok ? Eigen::Success : Eigen::NumericalIssue;
+  }
+
+  //############################//
+  //   Descente et remontee     //
+  //############################//
+
+  // X (n x m, range par lignes) est remplace par A^{-1} X.
+  // Aucune donnee membre n'est modifiee: la resolution est reentrante.
+  void solveInPlace(ValueType* X, const std::size_t& m) const {
+
+    std::vector<ValueType> Y(n*m);
+    for(std::size_t j=0; j<n; ++j){
+      std::copy(X+perm[j]*m,X+(perm[j]+1)*m,Y.data()+j*m);}
+    ValueType* y = Y.data();
+
+    // L y = b
+    for(std::size_t s=0; s<nsup; ++s){
+      const std::size_t  f  = sfirst[s];
+      const std::size_t  ns = rptr[s+1]-rptr[s];
+      const std::size_t  nc = sfirst[s+1]-f;
+      const std::size_t* r  = row.data()+rptr[s];
+      const ValueType*   L  = lval.data()+lptr[s];
+      for(std::size_t j=0; j<nc; ++j){
+	ValueType* yj = y+(f+j)*m;
+	const ValueType d = L[j+j*ns];
+	for(std::size_t k=0; k<m; ++k){yj[k] /= d;}
+	for(std::size_t i=j+1; i<ns; ++i){
+	  const ValueType c = L[i+j*ns];
+	  ValueType* yi = y+r[i]*m;
+	  for(std::size_t k=0; k<m; ++k){yi[k] -= c*yj[k];}
+	}
+      }
+    }
+
+    // L^T x = y
+    for(std::size_t s=nsup; s-->0;){
+      const std::size_t  f  = sfirst[s];
+      const std::size_t  ns = rptr[s+1]-rptr[s];
+      const std::size_t  nc = sfirst[s+1]-f;
+      const std::size_t* r  = row.data()+rptr[s];
+      const ValueType*   L  = lval.data()+lptr[s];
+      for(std::size_t j=nc; j-->0;){
+	ValueType* yj = y+(f+j)*m;
+	for(std::size_t i=j+1; i<ns; ++i){
+	  const ValueType  c  = L[i+j*ns];
+	  const ValueType* yi = y+r[i]*m;
+	  for(std::size_t k=0; k<m; ++k){yj[k] -= c*yi[k];}
+	}
+	const ValueType d = L[j+j*ns];
+	for(std::size_t k=0; k<m; ++k){yj[k] /= d;}
+      }
+    }
+
+    for(std::size_t j=0; j<n; ++j){
+      std::copy(Y.data()+j*m,Y.data()+(j+1)*m,X+perm[j]*m);}
+  }
+
+  template <typename Derived>
+  auto solve(const Eigen::MatrixBase<Derived>& B) const {
+    using ResultType = Eigen::Matrix<typename Derived::Scalar,Eigen::Dynamic,
+				     Derived::ColsAtCompileTime>;
+    using RowMajorType = Eigen::Matrix<ValueType,Eigen::Dynamic,Eigen::Dynamic,
+				       Eigen::RowMajor>;
+    assert(std::size_t(B.rows())==n);
+    RowMajorType X = B.template cast<ValueType>();
+    solveInPlace(X.data(),X.cols());
+    ResultType R = X.template cast<typename Derived::Scalar>();
+    return R;
+  }
+
+private:
+
+  //############################//
+  //    Etapes de l'analyse     //
+  //############################//
+
+  template <typename OtherValueType>
+  static Graph Adjacency(const Eigen::SparseMatrix<OtherValueType>& A){
+    const std::size_t n = A.rows();
+    const int* o = A.outerIndexPtr();
+    const int* i = A.innerIndexPtr();
+    Graph g(n);
+    for(std::size_t k=0; k<n; ++k){
+      for(int p=o[k]; p<o[k+1]; ++p){
+	if(std::size_t(i[p])!=k){++g.offset[i[p]+1]; ++g.offset[k+1];}}}
+    std::partial_sum(g.offset.begin(),g.offset.end(),g.offset.begin());
+    IndexContainer adj(g.offset[n]);
+    IndexContainer pos(g.offset.begin(),g.offset.end()-1);
+    for(std::size_t k=0; k<n; ++k){
+      for(int p=o[k]; p<o[k+1]; ++p){
+	if(std::size_t(i[p])!=k){adj[pos[i[p]]++] = k; adj[pos[k]++] = i[p];}}}
+    IndexContainer mark(n,npos);
+    g.adj.reserve(adj.size());
+    std::size_t q = 0;
+    for(std::size_t j=0; j<n; ++j){
+      for(; q<g.offset[j+1]; ++q){
+	if(mark[adj[q]]!=j){mark[adj[q]] = j; g.adj.push_back(adj[q]);}}
+      g.offset[j+1] = g.adj.size();
+    }
+    return g;
+  }
+
+  void Invert(){
+    iperm.resize(n);
+    for(std::size_t j=0; j<n; ++j){iperm[perm[j]] = j;}}
+
+  // Arbre d'elimination (Liu, avec compression des chemins)
+  template <typename OtherValueType>
+  void EliminationTree(const Eigen::SparseMatrix<OtherValueType>& A){
+    const int* o = A.outerIndexPtr();
+    const int* i = A.innerIndexPtr();
+    parent.assign(n,npos);
+    IndexContainer anc(n,npos);
+    for(std::size_t j=0; j<n; ++j){
+      const std::size_t k = perm[j];
+      for(int p=o[k]; p<o[k+1]; ++p){
+	std::size_t r = iperm[i[p]];
+	if(r>=j){continue;}
+	while(anc[r]!=npos && anc[r]!=j){
+	  std::size_t next = anc[r];
+	  anc[r] = j;
+	  r = next;}
+	if(anc[r]==npos){anc[r] = j; parent[r] = j;}
+      }
+    }
+  }
+
+  IndexContainer PostOrder() const {
+    IndexContainer head(n,npos), next(n,npos), post, stack;
+    post.reserve(n);
+    for(std::size_t j=n; j-->0;){
+      if(parent[j]!=npos){
+	next[j] = head[parent[j]];
+	head[parent[j]] = j;}
+    }
+    for(std::size_t r=0; r<n; ++r){
+      if(parent[r]!=npos){continue;}
+      stack.push_back(r);
+      while(!stack.empty()){
+	std::size_t j = stack.back();
+	if(head[j]!=npos){
+	  std::size_t c = head[j];
+	  head[j] = next[c];
+	  stack.push_back(c);}
+	else{
+	  post.push_back(j);
+	  stack.pop_back();}
+      }
+    }
+    return post;
+  }
+
+  // Nombre de coefficients par colonne de L (sous-arbres des lignes)
+  template <typename OtherValueType>
+  void ColumnCounts(const Eigen::SparseMatrix<OtherValueType>& A){
+    const int* o = A.outerIndexPtr();
+    const int* i = A.innerIndexPtr();
+    count.assign(n,1);
+    IndexContainer mark(n,npos);
+    for(std::size_t j=0; j<n; ++j){
+      mark[j] = j;
+      const std::size_t k = perm[j];
+      for(int p=o[k]; p<o[k+1]; ++p){
+	std::size_t r = iperm[i[p]];
+	if(r>=j){continue;}
+	for(; mark[r]!=j; r=parent[r]){
+	  mark[r] = j;
+	  ++count[r];}
+      }
+    }
+  }
+
+  // Supernoeuds relaches: la colonne j rejoint le supernoeud de j-1
+  // si j est le pere de j-1 et si les zeros ainsi stockes (le profil
+  // du supernoeud etant celui de sa derniere colonne) restent peu
+  // nombreux, d'autant moins que le supernoeud est large.
+  void Supernodes(){
+    sfirst.clear();
+    snode.resize(n);
+    std::size_t zeros = 0;
+    for(std::size_t j=0; j<n; ++j){
+      bool merge = false;
+      std::size_t z = 0;
+      if(j>0 && parent[j-1]==j){
+	const std::size_t nc = j-sfirst.back()+1;
+	z = zeros+(nc-1)*(count[j]+1-count[j-1]);
+	const double tot = nc*count[j]+nc*(nc-1)/2;
+	merge = z==0 || nc<=4 || (nc<=16 && z<=0.8*tot) ||
+	  (nc<=48 && z<=0.1*tot) || z<=0.05*tot;
+      }
+      if(merge){zeros = z;}
+      else{sfirst.push_back(j); zeros = 0;}
+      snode[j] = sfirst.size()-1;
+    }
+    nsup = sfirst.size();
+    sfirst.push_back(n);
+
+    sparent.assign(nsup,npos);
+    for(std::size_t s=0; s<nsup; ++s){
+      std::size_t p = parent[sfirst[s+1]-1];
+      if(p!=npos){sparent[s] = snode[p];}}
+
+    cptr.assign(nsup+1,0);
+    for(std::size_t s=0; s<nsup; ++s){
+      if(sparent[s]!=npos){++cptr[sparent[s]+1];}}
+    std::partial_sum(cptr.begin(),cptr.end(),cptr.begin());
+    child.resize(cptr[nsup]);
+    IndexContainer pos(cptr.begin(),cptr.end()-1);
+    for(std::size_t s=0; s<nsup; ++s){
+      if(sparent[s]!=npos){child[pos[sparent[s]]++] = s;}}
+  }
+
+  // Lignes de chaque supernoeud, positions des coefficients de A
+  // dans les matrices frontales et indices relatifs des fils
+  template <typename OtherValueType>
+  void RowStructure(const Eigen::SparseMatrix<OtherValueType>& A){
+    const int* o = A.outerIndexPtr();
+    const int* i = A.innerIndexPtr();
+    nnzA = A.nonZeros();
+
+    rptr.assign(nsup+1,0);
+    for(std::size_t s=0; s<nsup; ++s){
+      rptr[s+1] = rptr[s]+(sfirst[s+1]-sfirst[s]-1)+count[sfirst[s+1]-1];}
+    row.resize(rptr[nsup]);
+    lptr.assign(nsup+1,0);
+    for(std::size_t s=0; s<nsup; ++s){
+      lptr[s+1] = lptr[s]+(rptr[s+1]-rptr[s])*(sfirst[s+1]-sfirst[s]);}
+
+    IndexContainer mark(n,npos), local(n,npos);
+    aptr.assign(nsup+1,0);
+    apos.clear(); aval.clear();
+    uptr.assign(nsup+1,0);
+    for(std::size_t s=0; s<nsup; ++s){
+      const std::size_t f = sfirst[s], l = sfirst[s+1];
+      const std::size_t ns = rptr[s+1]-rptr[s];
+      uptr[s+1] = uptr[s]+ns-(l-f);
+    }
+    relind.resize(uptr[nsup]);
+
+    for(std::size_t s=0; s<nsup; ++s){
+      const std::size_t f = sfirst[s], l = sfirst[s+1];
+      std::size_t* r = row.data()+rptr[s];
+      std::size_t  nr = 0;
+      for(std::size_t j=f; j<l; ++j){mark[j] = s; r[nr++] = j;}
+
+      for(std::size_t j=f; j<l; ++j){
+	const std::size_t k = perm[j];
+	for(int p=o[k]; p<o[k+1]; ++p){
+	  std::size_t I = iperm[i[p]];
+	  if(I>=l && mark[I]!=s){mark[I] = s; r[nr++] = I;}}
+      }
+      for(std::size_t c=cptr[s]; c<cptr[s+1]; ++c){
+	const std::size_t sc = child[c];
+	for(std::size_t q=rptr[sc]; q<rptr[sc+1]; ++q){
+	  std::size_t I = row[q];
+	  if(I>=l && mark[I]!=s){mark[I] = s; r[nr++] = I;}}
+      }
+      assert(nr==rptr[s+1]-rptr[s]);
+      std::sort(r+(l-f),r+nr);
+      for(std::size_t q=0; q<nr; ++q){local[r[q]] = q;}
+
+      // Coefficients de A (triangle inferieur de P A P^T)
+      for(std::size_t j=f; j<l; ++j){
+	const std::size_t k = perm[j];
+	for(int p=o[k]; p<o[k+1]; ++p){
+	  std::size_t I = iperm[i[p]];
+	  if(I>=j){
+	    apos.push_back(local[I]+(j-f)*nr);
+	    aval.push_back(p);}
+	}
+      }
+      aptr[s+1] = apos.size();
+
+      // Indices relatifs des lignes de mise a jour des fils
+      for(std::size_t c=cptr[s]; c<cptr[s+1]; ++c){
+	const std::size_t sc = child[c];
+	const std::size_t nc = sfirst[sc+1]-sfirst[sc];
+	std::size_t* ri = relind.data()+uptr[sc];
+	for(std::size_t q=rptr[sc]+nc; q<rptr[sc+1]; ++q){
+	  *(ri++) = local[row[q]];}
+      }
+    }
+  }
+
+  // Niveaux de l'arbre des supernoeuds (feuilles au niveau 0)
+  void Levels(){
+    IndexContainer height(nsup,0);
+    std::size_t hmax = 0;
+    for(std::size_t s=0; s<nsup; ++s){
+      hmax = std::max(hmax,height[s]);
+      if(sparent[s]!=npos){
+	height[sparent[s]] = std::max(height[sparent[s]],height[s]+1);}
+    }
+    level.assign(nsup>0 ? hmax+1 : 0,{});
+    for(std::size_t s=0; s<nsup; ++s){level[height[s]].push_back(s);}
+  }
+
+  //############################//
+  //      Noyaux denses         //
+  //############################//
+
+  // F (ns x ns, par colonnes, triangle inferieur) : factorisation des
+  // nc premieres colonnes, le bloc restant recevant le complement de
+  // Schur. Algorithme par blocs de colonnes, mises a jour de rang
+  // block effectuees par tuiles 8x4 (triangle superieur ignore).
+  static bool PartialCholesky(ValueType* F,
+			      const std::size_t& ns,
+			      const std::size_t& nc,
+			      const bool& parallel){
+
+    for(std::size_t j0=0; j0<nc; j0+=block){
+      const std::size_t j1 = std::min(j0+block,nc);
+
+      // Panneau j0..j1
+      for(std::size_t j=j0; j<j1; ++j){
+	ValueType* Fj = F+j*ns;
+	for(std::size_t p=j0; p<j; ++p){
+	  const ValueType* Fp = F+p*ns;
+	  const ValueType  c  = Fp[j];
+	  for(std::size_t i=j; i<ns; ++i){Fj[i] -= c*Fp[i];}
+	}
+	if(!(Fj[j]>0)){return false;}
+	const ValueType d = std::sqrt(Fj[j]);
+	Fj[j] = d;
+	for(std::size_t i=j+1; i<ns; ++i){Fj[i] /= d;}
+      }
+
+      // Colonnes restantes
+      const std::size_t nk = ns-j1;
+      const std::size_t nb = (nk+31)/32;
+      auto update = [&](const std::size_t& b){
+	const std::size_t k0 = j1+32*b, k1 = std::min(k0+32,ns);
+	for(std::size_t k=k0; k<k1; k+=4){
+	  const std::size_t mk = std::min<std::size_t>(4,k1-k);
+	  for(std::size_t i=k; i<ns; i+=8){
+	    const std::size_t mi = std::min<std::size_t>(8,ns-i);
+	    ValueType acc[4][8] = {};
+	    if(mk==4 && mi==8){
+	      for(std::size_t j=j0; j<j1; ++j){
+		const ValueType* Lj = F+j*ns;
+		for(std::size_t q=0; q<4; ++q){
+		  const ValueType c = Lj[k+q];
+		  for(std::size_t r=0; r<8; ++r){acc[q][r] += Lj[i+r]*c;}}
+	      }
+	    }
+	    else{
+	      for(std::size_t j=j0; j<j1; ++j){
+		const ValueType* Lj = F+j*ns;
+		for(std::size_t q=0; q<mk; ++q){
+		  const ValueType c = Lj[k+q];
+		  for(std::size_t r=0; r<mi; ++r){acc[q][r] += Lj[i+r]*c;}}
+	      }
+	    }
+	    for(std::size_t q=0; q<mk; ++q){
+	      ValueType* Fk = F+(k+q)*ns+i;
+	      for(std::size_t r=0; r<mi; ++r){Fk[r] -= acc[q][r];}}
+	  }
+	}
+      };
+      if(parallel && nb>1){
+	ParallelTasks(nb,[&](const std::size_t& b, const std::size_t&){update(b);});}
+      else{
+	for(std::size_t b=0; b<nb; ++b){update(b);}}
+    }
+    return true;
+  }
+
+  //############################//
+  //      Donnees membres       //
+  //############################//
+
+  OrderingType               ordering;
+  Eigen::ComputationInfo     status = Eigen::Success;
+  std::size_t                n      = 0;
+  std::size_t                nnzA   = 0;
+  std::size_t                nsup   = 0;
+
+  IndexContainer             perm, iperm;   // perm[nouveau] = ancien
+  IndexContainer             parent, count; // arbre, profils de L
+  IndexContainer             sfirst, snode; // colonnes des supernoeuds
+  IndexContainer             sparent;       // arbre des supernoeuds
+  IndexContainer             cptr, child;   // fils des supernoeuds
+  IndexContainer             rptr, row;     // lignes des supernoeuds
+  IndexContainer             lptr;          // blocs de L
+  IndexContainer             aptr, apos, aval; // assemblage de A
+  IndexContainer             uptr, relind;  // indices relatifs des fils
+  std::vector<IndexContainer> level;        // niveaux de l'arbre
+  ValueContainer             lval;          // coefficients de L
+
+};
+
+
+#endif
@@ -7,6 +7,8 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <numeric>
+#include "parallel.hpp"
 
 template <typename ValueType>
 bool less_col(const std::tuple<std::size_t, std::size_t, ValueType>& a,
@@ -178,6 +180,40 @@ public:
     }    
   }
   
+  // Meme resultat que sort() pour less_row, en temps lineaire:
+  // tri par denombrement sur les lignes puis tri stable de chaque
+  // ligne (en parallele). Les doublons sont sommes dans l'ordre
+  // d'insertion, le resultat ne depend donc pas du nombre de threads.
+  void compress() const {
+    auto& data = *data_ptr;
+    std::vector<std::size_t> row(nr+1,0);
+    for(const auto& [j,k,v]:data){++row[j+1];}
+    std::partial_sum(row.begin(),row.end(),row.begin());
+
+    ContainerType tmp(data.size());
+    std::vector<std::size_t> pos(row.begin(),row.end()-1);
+    for(const auto& jkv:data){tmp[pos[std::get<0>(jkv)]++] = jkv;}
+
+    std::vector<std::size_t> len(nr+1,0);
+    ParallelFor(nr,[&](const std::size_t& j){
+      auto b = tmp.begin()+row[j], e = tmp.begin()+row[j+1];
+      std::stable_sort(b,e,less_row<ValueType>);
+      auto out = b;
+      for(auto it=b; it!=e; ++it){
+	if(out!=b && std::get<1>(*std::prev(out))==std::get<1>(*it)){
+	  std::get<2>(*std::prev(out)) += std::get<2>(*it);}
+	else{*out++ = *it;}
+      }
+      len[j+1] = out-b;
+    });
+    std::partial_sum(len.begin(),len.end(),len.begin());
+
+    data.resize(len[nr]);
+    ParallelFor(nr,[&](const std::size_t& j){
+      std::copy(tmp.begin()+row[j],tmp.begin()+row[j]+(len[j+1]-len[j]),
+		data.begin()+len[j]);});
+  }
+
   auto T() const {
     ThisType mt(nc,nr);
     mt.reserve(data_ptr->size());
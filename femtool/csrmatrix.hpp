@@ -0,0 +1,320 @@
+#ifndef CSRMATRIX_HPP
+#define CSRMATRIX_HPP
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "coomatrix.hpp"
+#include "parallel.hpp"
+
+// Stockage compresse par lignes. Le profil (rows,cols) est partage
+// entre les matrices qui ont le meme profil: seules les valeurs sont
+// propres a chaque matrice.
+template <typename VALUE_TYPE>
+class CsrMatrix{
+
+public:
+
+  using ValueType      = VALUE_TYPE;
+  using ThisType       = CsrMatrix<ValueType>;
+  using IndexContainer = std::vector<std::size_t>;
+  using ValueContainer = std::vector<ValueType>;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  CsrMatrix(const std::size_t& nr0 = 0,
+	    const std::size_t& nc0 = 0):
+    nr(nr0), nc(nc0),
+    rows_ptr(std::make_shared<IndexContainer>(nr0+1,0)),
+    cols_ptr(std::make_shared<IndexContainer>()),
+    vals_ptr(std::make_shared<ValueContainer>()) {};
+
+  // Profil donne, valeurs nulles
+  CsrMatrix(const std::size_t& nr0,
+	    const std::size_t& nc0,
+	    const std::shared_ptr<const IndexContainer>& rows0,
+	    const std::shared_ptr<const IndexContainer>& cols0):
+    nr(nr0), nc(nc0), rows_ptr(rows0), cols_ptr(cols0),
+    vals_ptr(std::make_shared<ValueContainer>(cols0->size(),ValueType())) {
+    assert(rows0->size()==nr0+1 && rows0->back()==cols0->size());}
+
+  template <typename OtherValueType>
+  CsrMatrix(const CooMatrix<OtherValueType>& A):
+    nr(NbRow(A)), nc(NbCol(A)) {
+    CooMatrix<ValueType> B = A;
+    B.compress();
+    auto rows = std::make_shared<IndexContainer>(nr+1,0);
+    auto cols = std::make_shared<IndexContainer>();
+    auto vals = std::make_shared<ValueContainer>();
+    cols->reserve(GetData(B).size());
+    vals->reserve(GetData(B).size());
+    for(const auto& [j,k,v]:B){
+      ++(*rows)[j+1];
+      cols->push_back(k);
+      vals->push_back(v);}
+    for(std::size_t j=0; j<nr; ++j){(*rows)[j+1] += (*rows)[j];}
+    rows_ptr = rows; cols_ptr = cols; vals_ptr = vals;
+  }
+
+  CsrMatrix(const CsrMatrix&)            = default;
+  CsrMatrix(CsrMatrix&&)                 = default;
+  CsrMatrix& operator=(const CsrMatrix&) = default;
+  CsrMatrix& operator=(CsrMatrix&&)      = default;
+
+  friend std::size_t
+  NbRow(const ThisType& m){return m.nr;}
+
+  friend std::size_t
+  NbCol(const ThisType& m){return m.nc;}
+
+  friend std::size_t
+  Nnz(const ThisType& m){return m.cols_ptr->size();}
+
+  friend const IndexContainer&
+  Rows(const ThisType& m){return *m.rows_ptr;}
+
+  friend const IndexContainer&
+  Cols(const ThisType& m){return *m.cols_ptr;}
+
+  friend const ValueContainer&
+  Values(const ThisType& m){return *m.vals_ptr;}
+
+  friend ValueContainer&
+  Values(ThisType& m){return *m.vals_ptr;}
+
+  friend bool
+  SamePattern(const ThisType& m1, const ThisType& m2){
+    return (m1.nr==m2.nr) && (m1.nc==m2.nc) &&
+      ( (m1.cols_ptr==m2.cols_ptr && m1.rows_ptr==m2.rows_ptr) ||
+	(*m1.rows_ptr==*m2.rows_ptr && *m1.cols_ptr==*m2.cols_ptr) );}
+
+  // Matrice de meme profil, valeurs copiees
+  friend ThisType
+  Copy(const ThisType& m){
+    ThisType new_m(m);
+    new_m.vals_ptr = std::make_shared<ValueContainer>(*m.vals_ptr);
+    return new_m;
+  }
+
+  // Position de (j,k) dans le tableau des valeurs, npos si absent
+  std::size_t find(const std::size_t& j,
+		   const std::size_t& k) const {
+    const auto& rows = *rows_ptr;
+    const auto& cols = *cols_ptr;
+    auto b  = cols.begin()+rows[j], e = cols.begin()+rows[j+1];
+    auto it = std::lower_bound(b,e,k);
+    return (it!=e && *it==k) ? std::size_t(it-cols.begin()) : npos;
+  }
+
+  template <typename OtherValueType> auto
+  operator()(const std::vector<OtherValueType>& x) const {
+    assert(x.size()==nc);
+    using CommonType = std::common_type_t<ValueType,OtherValueType>;
+    std::vector<CommonType> y(nr,CommonType());
+    return (*this)(x,y);
+  }
+
+  template <typename ValueType1, typename ValueType2>
+  auto& operator()(const std::vector<ValueType1>& x,
+		   std::vector<ValueType2>& y) const {
+    assert(x.size()==nc);
+    assert(y.size()==nr);
+    const auto& rows = *rows_ptr;
+    const auto& cols = *cols_ptr;
+    const auto& vals = *vals_ptr;
+    ParallelRange(nr,[&](const std::size_t& b,
+			 const std::size_t& e,
+			 const std::size_t&){
+      for(std::size_t j=b; j<e; ++j){
+	ValueType2 yj = ValueType2();
+	for(std::size_t p=rows[j]; p<rows[j+1]; ++p){
+	  yj += vals[p]*x[cols[p]];}
+	y[j] += yj;
+      }
+    });
+    return y;
+  }
+
+  template <typename OtherValueType>
+  auto operator*(const std::vector<OtherValueType>& x) const {
+    assert(x.size()==nc);
+    return (*this)(x);}
+
+  template <typename S>
+  requires std::same_as<S,double> || std::same_as<S,std::complex<double>>
+  auto& operator*=(const S& a){
+    for(auto& v:*vals_ptr){v*=a;}
+    return *this;
+  }
+
+  // Additions entre matrices de meme profil
+  ThisType& operator+=(const ThisType& m){
+    assert(SamePattern(*this,m));
+    auto& vals = *vals_ptr;
+    const auto& mvals = *m.vals_ptr;
+    for(std::size_t p=0; p<vals.size(); ++p){vals[p] += mvals[p];}
+    return *this;
+  }
+
+  ThisType& operator-=(const ThisType& m){
+    assert(SamePattern(*this,m));
+    auto& vals = *vals_ptr;
+    const auto& mvals = *m.vals_ptr;
+    for(std::size_t p=0; p<vals.size(); ++p){vals[p] -= mvals[p];}
+    return *this;
+  }
+
+  friend CooMatrix<ValueType>
+  MakeCoo(const ThisType& m){
+    CooMatrix<ValueType> new_m(m.nr,m.nc);
+    new_m.reserve(Nnz(m));
+    const auto& rows = *m.rows_ptr;
+    const auto& cols = *m.cols_ptr;
+    const auto& vals = *m.vals_ptr;
+    for(std::size_t j=0; j<m.nr; ++j){
+      for(std::size_t p=rows[j]; p<rows[j+1]; ++p){
+	new_m.push_back(j,cols[p],vals[p]);}}
+    return new_m;
+  }
+
+  friend DenseMatrix<ValueType>
+  MakeDense(const ThisType& m){
+    return MakeDense(MakeCoo(m));}
+
+  friend std::ostream&
+  operator<<(std::ostream& o, const ThisType& m){
+    return o << MakeDense(m);}
+
+private:
+
+  //Data members
+  std::size_t                                nr,nc;
+  std::shared_ptr<const IndexContainer>   rows_ptr;
+  std::shared_ptr<const IndexContainer>   cols_ptr;
+  std::shared_ptr<ValueContainer>         vals_ptr;
+
+};
+
+
+// Combinaison a*A + b*B de matrices de meme profil
+template <typename ValueType>
+CsrMatrix<ValueType>
+LinearCombination(const double& a, const CsrMatrix<ValueType>& A,
+		  const double& b, const CsrMatrix<ValueType>& B){
+  assert(SamePattern(A,B));
+  auto C = Copy(A);
+  auto& c = Values(C);
+  const auto& bv = Values(B);
+  ParallelFor(c.size(),[&](const std::size_t& p){
+    c[p] = a*c[p]+b*bv[p];});
+  return C;
+}
+
+
+//############################//
+//  Extraction de sous-blocs  //
+//############################//
+
+// Sous-matrice A(ri,ci) en O(nnz des lignes retenues): marker
+// (taille NbCol(A), rempli de npos) donne le numero local des
+// colonnes retenues et est restitue dans son etat initial.
+template <typename ValueType>
+CsrMatrix<ValueType> Extract(const CsrMatrix<ValueType>& A,
+			     const std::vector<std::size_t>& ri,
+			     const std::vector<std::size_t>& ci,
+			     std::vector<std::size_t>& marker){
+
+  constexpr std::size_t npos = CsrMatrix<ValueType>::npos;
+  assert(marker.size()==NbCol(A));
+  for(std::size_t k=0; k<ci.size(); ++k){marker[ci[k]] = k;}
+
+  const auto& rows = Rows(A);
+  const auto& cols = Cols(A);
+  const auto& vals = Values(A);
+  auto sub_rows = std::make_shared<std::vector<std::size_t>>(ri.size()+1,0);
+  auto sub_cols = std::make_shared<std::vector<std::size_t>>();
+  std::vector<ValueType> sub_vals;
+  for(std::size_t j=0; j<ri.size(); ++j){
+    for(std::size_t p=rows[ri[j]]; p<rows[ri[j]+1]; ++p){
+      if(marker[cols[p]]!=npos){
+	sub_cols->push_back(marker[cols[p]]);
+	sub_vals.push_back(vals[p]);}
+    }
+    (*sub_rows)[j+1] = sub_cols->size();
+  }
+  for(const auto& k:ci){marker[k] = npos;}
+
+  // Colonnes locales croissantes par ligne si ci n'est pas trie
+  if(!std::is_sorted(ci.begin(),ci.end())){
+    std::vector<std::pair<std::size_t,ValueType>> row;
+    for(std::size_t j=0; j<ri.size(); ++j){
+      std::size_t b = (*sub_rows)[j], e = (*sub_rows)[j+1];
+      row.clear();
+      for(std::size_t p=b; p<e; ++p){row.emplace_back((*sub_cols)[p],sub_vals[p]);}
+      std::sort(row.begin(),row.end(),[](const auto& x, const auto& y){
+	return x.first<y.first;});
+      for(std::size_t p=b; p<e; ++p){
+	(*sub_cols)[p] = row[p-b].first;
+	sub_vals[p]    = row[p-b].second;}
+    }
+  }
+
+  CsrMatrix<ValueType> B(ri.size(),ci.size(),sub_rows,sub_cols);
+  Values(B) = std::move(sub_vals);
+  return B;
+}
+
+template <typename ValueType>
+CsrMatrix<ValueType> Extract(const CsrMatrix<ValueType>& A,
+			     const std::vector<std::size_t>& ri,
+			     const std::vector<std::size_t>& ci){
+  std::vector<std::size_t> marker(NbCol(A),CsrMatrix<ValueType>::npos);
+  return Extract(A,ri,ci,marker);}
+
+// Sous-matrice principale A(idx,idx)
+template <typename ValueType>
+CsrMatrix<ValueType> Extract(const CsrMatrix<ValueType>& A,
+			     const std::vector<std::size_t>& idx){
+  return Extract(A,idx,idx);}
+
+// Blocs principaux de plusieurs sous-domaines, extraits en parallele
+template <typename ValueType>
+std::vector<CsrMatrix<ValueType>>
+Extract(const CsrMatrix<ValueType>& A,
+	const std::vector<std::vector<std::size_t>>& parts){
+
+  std::vector<CsrMatrix<ValueType>> sub(parts.size());
+  std::vector<std::vector<std::size_t>> marker(NbThread());
+  ParallelTasks(parts.size(),
+		[&](const std::size_t& p, const std::size_t& t){
+		  if(marker[t].empty()){
+		    marker[t].assign(NbCol(A),CsrMatrix<ValueType>::npos);}
+		  sub[p] = Extract(A,parts[p],parts[p],marker[t]);
+		});
+  return sub;
+}
+
+// Indices retenus par une restriction booleenne R (R(i,idx[i]) = 1)
+std::vector<std::size_t> RestrictionIndices(const CooMatrix<double>& R){
+  std::vector<std::size_t> idx(NbRow(R),CsrMatrix<double>::npos);
+  for(const auto& [i,k,v]:R){
+    if(v!=0.){
+      assert(idx[i]==CsrMatrix<double>::npos || idx[i]==k);
+      idx[i] = k;}
+  }
+  assert(std::find(idx.begin(),idx.end(),CsrMatrix<double>::npos)==idx.end());
+  return idx;
+}
+
+// R A R^T pour une restriction booleenne R
+template <typename ValueType>
+CsrMatrix<ValueType> Extract(const CsrMatrix<ValueType>& A,
+			     const CooMatrix<double>& R){
+  assert(NbCol(R)==NbRow(A) && NbRow(A)==NbCol(A));
+  return Extract(A,RestrictionIndices(R));}
+
+
+#endif
@@ -3,19 +3,47 @@
 
 #include <Eigen/Sparse>
 #include <Eigen/SparseLU>
+#include <Eigen/SparseCholesky>
+#include <Eigen/OrderingMethods>
+#include <variant>
+#include <limits>
+#include <algorithm>
 #include "coomatrix.hpp"
+#include "csrmatrix.hpp"
+#include "densematrix.hpp"
+#include "cholesky.hpp"
+#include "factorstats.hpp"
 
 template <typename T>
 void Copy(const CooMatrix<T>& A,
 	  Eigen::SparseMatrix<T>& Ae){
 
-  using NxNxT = Eigen::Triplet<double>;
+  using NxNxT = Eigen::Triplet<T>;
   std::vector<NxNxT> jkv;
   for(const auto& [j,k,v]:A){
     jkv.push_back(NxNxT(int(j),int(k),v));}
   Ae.setFromTriplets(jkv.begin(),jkv.end());
 }
 
+// Le stockage CSR est recopie tel quel en stockage par lignes,
+// puis transpose en O(nnz) vers le stockage par colonnes d'Eigen
+template <typename T>
+void Copy(const CsrMatrix<T>& A,
+	  Eigen::SparseMatrix<T>& Ae){
+
+  Eigen::SparseMatrix<T,Eigen::RowMajor> Ar(NbRow(A),NbCol(A));
+  Ar.resizeNonZeros(Nnz(A));
+  const auto& rows = Rows(A);
+  const auto& cols = Cols(A);
+  const auto& vals = Values(A);
+  for(std::size_t j=0; j<=NbRow(A); ++j){
+    Ar.outerIndexPtr()[j] = int(rows[j]);}
+  for(std::size_t p=0; p<Nnz(A); ++p){
+    Ar.innerIndexPtr()[p] = int(cols[p]);
+    Ar.valuePtr()[p]      = vals[p];}
+  Ae = Ar;
+}
+
 template <typename T>
 void Copy(const std::vector<T>& u,
 	  Eigen::Matrix<T,Eigen::Dynamic,1>& ue){
@@ -28,6 +56,152 @@ void Copy(const Eigen::Matrix<T,Eigen::Dynamic,1>& ue,
   u.resize(ue.size());
   for(std::size_t j=0; j<u.size(); ++j){u[j] = ue[j];}}
 
+// Seconds membres multiples: une colonne par second membre
+template <typename T>
+void Copy(const DenseMatrix<T>& B,
+	  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>& Be){
+  using RowMajorType = Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>;
+  Be = Eigen::Map<const RowMajorType>(GetData(B).data(),NbRow(B),NbCol(B));}
+
+template <typename T>
+void Copy(const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>& Be,
+	  DenseMatrix<T>& B){
+  using RowMajorType = Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>;
+  B = DenseMatrix<T>(Be.rows(),Be.cols());
+  Eigen::Map<RowMajorType>(GetData(B).data(),Be.rows(),Be.cols()) = Be;}
+
+template <typename T>
+void Copy(const std::vector<std::vector<T>>& b,
+	  Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>& Be){
+  Be.resize(b.empty() ? 0 : b[0].size(),b.size());
+  for(std::size_t k=0; k<b.size(); ++k){
+    assert(b[k].size()==std::size_t(Be.rows()));
+    Be.col(k) = Eigen::Map<const Eigen::Matrix<T,Eigen::Dynamic,1>>(b[k].data(),Be.rows());}
+}
+
+template <typename T>
+void Copy(const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>& Be,
+	  std::vector<std::vector<T>>& b){
+  b.resize(Be.cols());
+  for(std::size_t k=0; k<b.size(); ++k){
+    b[k].resize(Be.rows());
+    Eigen::Map<Eigen::Matrix<T,Eigen::Dynamic,1>>(b[k].data(),Be.rows()) = Be.col(k);}
+}
+
+// Descente-remontee par blocs pour les factorisations de Cholesky
+// simpliciales: les m seconds membres sont ranges par lignes, si
+// bien que chaque coefficient de L n'est lu qu'une fois et met a
+// jour m valeurs contigues.
+template <typename FactorType, typename T>
+void BlockSolve(const FactorType& f,
+		const Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>& B,
+		Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic>& X){
+
+  using RowMajorType = Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>;
+  constexpr bool ldlt = requires{f.vectorD();};
+  const auto& L = f.matrixL().nestedExpression();
+  const int* outer = L.outerIndexPtr();
+  const int* inner = L.innerIndexPtr();
+  const T*   val   = L.valuePtr();
+  const std::size_t n = B.rows(), m = B.cols();
+  const auto& P = f.permutationP().indices();
+
+  RowMajorType Y(n,m);
+  for(std::size_t i=0; i<n; ++i){
+    Y.row(P.size()>0 ? P[i] : i) = B.row(i);}
+  T* y = Y.data();
+
+  // L y = b
+  for(std::size_t j=0; j<n; ++j){
+    T* yj = y+j*m;
+    for(int p=outer[j]; p<outer[j+1]; ++p){
+      std::size_t i = inner[p];
+      if(i==j){
+	if constexpr(!ldlt){
+	  for(std::size_t k=0; k<m; ++k){yj[k] /= val[p];}}
+	continue;}
+      T* yi = y+i*m;
+      for(std::size_t k=0; k<m; ++k){yi[k] -= val[p]*yj[k];}
+    }
+  }
+
+  if constexpr(ldlt){
+    const auto& D = f.vectorD();
+    for(std::size_t j=0; j<n; ++j){
+      for(std::size_t k=0; k<m; ++k){y[j*m+k] /= D[j];}}
+  }
+
+  // L^* x = y
+  for(std::size_t j=n; j-->0;){
+    T* yj = y+j*m;
+    T  d  = T(1);
+    for(int p=outer[j]; p<outer[j+1]; ++p){
+      std::size_t i = inner[p];
+      if(i==j){d = val[p]; continue;}
+      const T  c  = Eigen::numext::conj(val[p]);
+      const T* yi = y+i*m;
+      for(std::size_t k=0; k<m; ++k){yj[k] -= c*yi[k];}
+    }
+    if constexpr(!ldlt){
+      for(std::size_t k=0; k<m; ++k){yj[k] /= Eigen::numext::conj(d);}}
+  }
+
+  X.resize(n,m);
+  for(std::size_t i=0; i<n; ++i){
+    X.row(i) = Y.row(P.size()>0 ? P[i] : i);}
+}
+
+
+// Coefficients, operations et memoire d'une factorisation: seul
+// le decompte des operations de SparseLU n'est pas disponible.
+template <typename FactorType>
+void FactorCost(const FactorType& f,
+		FactorStats& s){
+  if constexpr(requires{f.supernodes();}){
+    s.nnzF   = f.nonZeros();
+    s.flops  = f.flops();
+    s.memory = f.memory();
+    s.peak   = s.memory+f.workspace();
+  }
+  else if constexpr(requires{f.nnzU();}){
+    using T = typename FactorType::Scalar;
+    s.nnzF   = f.nnzL()+f.nnzU();
+    s.flops  = 0.;
+    s.memory = s.nnzF*(sizeof(T)+sizeof(int))+4*s.n*sizeof(int);
+    s.peak   = s.memory;
+  }
+  else{
+    // Cholesky simpliciale ou incomplete: L par colonnes
+    const auto& L = [&f]() -> const auto& {
+      if constexpr(requires{f.matrixL().nestedExpression();}){
+	return f.matrixL().nestedExpression();}
+      else{return f.matrixL();}}();
+    using T = typename std::decay_t<decltype(L)>::Scalar;
+    constexpr bool ldlt = requires{f.vectorD();};
+    const int* o = L.outerIndexPtr();
+    std::vector<std::size_t> c(L.cols());
+    for(std::size_t j=0; j<c.size(); ++j){c[j] = o[j+1]-o[j]+(ldlt ? 1 : 0);}
+    s.nnzF   = L.nonZeros()+(ldlt ? L.cols() : 0);
+    s.flops  = CholeskyFlops(c);
+    s.memory = s.nnzF*(sizeof(T)+sizeof(int))+3*s.n*sizeof(int);
+    s.peak   = s.memory;
+  }
+}
+
+
+// Choix de la factorisation: LU (COLAMD), Cholesky LL^T ou LDL^T
+// (AMD), Cholesky multifrontale (dissection emboitee, cholesky.hpp),
+// ou choix automatique selon la symetrie de la matrice (LL^T, puis
+// LU si la matrice n'est pas definie positive).
+enum class SolverType{Auto,LU,LLT,LDLT,Supernodal};
+
+template <typename ValueType>
+bool IsSymmetric(const Eigen::SparseMatrix<ValueType>& Ae,
+		 const double& tol = 1e-12){
+  if(Ae.rows()!=Ae.cols()){return false;}
+  Eigen::SparseMatrix<ValueType> At = Ae.transpose();
+  return (Ae-At).norm() <= tol*Ae.norm();
+}
 
 template <typename VALUE_TYPE>
 class InvCooMatrix{
@@ -38,25 +212,32 @@ public:
   using ThisType        = InvCooMatrix<ValueType>;  
   using EigenVectorType = Eigen::Matrix<ValueType,Eigen::Dynamic,1>;
   using EigenMatrixType = Eigen::SparseMatrix<ValueType>;
-  using EigenOrderType  = Eigen::COLAMDOrdering<int>;
-  using ContainerType   = Eigen::SparseLU<EigenMatrixType,
-					  EigenOrderType>;
-
-  InvCooMatrix(const CooMatrix<ValueType>& A):
-    nr(NbRow(A)), nc(NbCol(A)),
-    data_ptr(std::make_shared<ContainerType>()),
-    u_ptr(std::make_shared<EigenVectorType>()),
-    b_ptr(std::make_shared<EigenVectorType>())
-  {
-    assert( nr==nc );
-    Eigen::SparseMatrix<double> Ae(nr,nc);
-    Copy(A,Ae);
-    data_ptr->analyzePattern(Ae);
-    data_ptr->factorize(Ae);
-    u_ptr->resize(nr);
-    b_ptr->resize(nc);
+  using EigenDenseType  = Eigen::Matrix<ValueType,Eigen::Dynamic,Eigen::Dynamic>;
+  using LuType          = Eigen::SparseLU<EigenMatrixType,
+					  Eigen::COLAMDOrdering<int>>;
+  using LltType         = Eigen::SimplicialLLT<EigenMatrixType,Eigen::Lower,
+					       Eigen::AMDOrdering<int>>;
+  using LdltType        = Eigen::SimplicialLDLT<EigenMatrixType,Eigen::Lower,
+						Eigen::AMDOrdering<int>>;
+  using SupernodalType  = SupernodalCholesky<ValueType>;
+  using ContainerType   = std::variant<LuType,LltType,LdltType,SupernodalType>;
+
+  // Profil de la derniere analyse, choix du mode Auto pour ce
+  // profil et succes de la derniere factorisation numerique
+  struct PatternType{
+    std::vector<int>  outer, inner;
+    SolverType        choice = SolverType::Auto;
+    bool              ok     = false;
   };
 
+  InvCooMatrix(const CooMatrix<ValueType>& A,
+	       const SolverType& type0 = SolverType::Auto):
+    InvCooMatrix(NbRow(A),NbCol(A),type0) {factorize(A);}
+
+  InvCooMatrix(const CsrMatrix<ValueType>& A,
+	       const SolverType& type0 = SolverType::Auto):
+    InvCooMatrix(NbRow(A),NbCol(A),type0) {factorize(A);}
+
   InvCooMatrix()                               = default;
   InvCooMatrix(const InvCooMatrix&)            = default;
   InvCooMatrix(InvCooMatrix&&)                 = default;
@@ -68,34 +249,378 @@ public:
   friend std::size_t
   NbCol(const ThisType& m){return m.nc;}
 
-  auto operator()(const std::vector<ValueType>& b) const {
+  // Factorisation effectivement utilisee (jamais Auto)
+  friend SolverType
+  Type(const ThisType& m){return m.data_ptr->first;}
 
-    auto& ue = *u_ptr;
-    auto& be = *b_ptr;
-    
-    Copy(b,be);
-    ue = data_ptr->solve(*b_ptr);
-    std::vector<ValueType> u;
-    Copy(ue,u);
-    
+  // Statistiques cumulees depuis la construction (partagees par
+  // les copies, comme la factorisation)
+  friend FactorStats
+  Stats(const ThisType& m){
+    return m.stats_ptr ? m.stats_ptr->get() : FactorStats();}
+
+  // Succes de la derniere factorisation numerique. En cas d'echec,
+  // les resolutions renvoient des NaN.
+  friend bool
+  Factorized(const ThisType& m){
+    return m.pattern_ptr && m.pattern_ptr->ok;}
+
+  // Nouvelle factorisation numerique. Si le profil de A est celui
+  // de la factorisation precedente, la renumerotation et l'analyse
+  // symbolique sont reutilisees; sinon elles sont refaites. En mode
+  // Auto, la symetrie des valeurs est testee a chaque appel et
+  // l'analyse est refaite si la factorisation choisie change.
+  // Renvoie true si l'analyse a ete reutilisee. Les copies de
+  // l'inverse partagent la factorisation et voient donc la mise a
+  // jour.
+  template <typename MatrixType>
+  bool factorize(const MatrixType& A){
+    assert( NbRow(A)==nr && NbCol(A)==nc );
+    EigenMatrixType Ae(nr,nc);
+    Copy(A,Ae);
+    Ae.makeCompressed();
+
+    auto& pat = *pattern_ptr;
+    const int* o = Ae.outerIndexPtr();
+    const int* i = Ae.innerIndexPtr();
+    bool same = pat.outer.size()==nc+1
+      && pat.inner.size()==std::size_t(Ae.nonZeros())
+      && std::equal(pat.outer.begin(),pat.outer.end(),o)
+      && std::equal(pat.inner.begin(),pat.inner.end(),i);
+
+    using ClockType = FactorStatsData::ClockType;
+    auto& stats = stats_ptr->stats;
+    auto t0 = ClockType::now();
+    auto& [used,solver] = *data_ptr;
+    SolverType choice = type;
+    if(type==SolverType::Auto){
+      choice = IsSymmetric(Ae) ? SolverType::LLT : SolverType::LU;}
+    if(!same || choice!=pat.choice){
+      pat.outer.assign(o,o+nc+1);
+      pat.inner.assign(i,i+Ae.nonZeros());
+      pat.choice = choice;
+      used = choice;
+      emplace(used);
+      std::visit([&Ae](auto& f){f.analyzePattern(Ae);},solver);
+      stats.t_analyze += FactorStatsData::Seconds(t0);
+      t0 = ClockType::now();
+      same = false;
+    }
+
+    bool ok = std::visit([&Ae](auto& f){
+      f.factorize(Ae); return f.info()==Eigen::Success;},solver);
+
+    // Matrice symetrique non definie positive: repli sur LU (conserve
+    // tant que le profil et le choix ne changent pas)
+    if(!ok && type==SolverType::Auto && used!=SolverType::LU){
+      stats.t_factor += FactorStatsData::Seconds(t0);
+      t0 = ClockType::now();
+      used = SolverType::LU;
+      emplace(used);
+      auto& f = std::get<LuType>(solver);
+      f.analyzePattern(Ae);
+      stats.t_analyze += FactorStatsData::Seconds(t0);
+      t0 = ClockType::now();
+      f.factorize(Ae);
+      ok = f.info()==Eigen::Success;
+      same = false;
+    }
+    pat.ok = ok;
+    assert(ok);
+
+    stats.t_factor += FactorStatsData::Seconds(t0);
+    ++stats.count;
+    stats.n    = nr;
+    stats.nnzA = Ae.nonZeros();
+    std::visit([&stats](const auto& f){FactorCost(f,stats);},solver);
+    return same;
+  }
+
+  // Resolution reentrante: aucune donnee partagee n'est modifiee,
+  // plusieurs threads peuvent utiliser la meme factorisation.
+  void solve(const std::vector<ValueType>& b,
+	     std::vector<ValueType>& u) const {
+    assert(b.size()==nc);
+    auto t0 = FactorStatsData::ClockType::now();
+    u.resize(nr);
+    Eigen::Map<const EigenVectorType> be(b.data(),nc);
+    Eigen::Map<EigenVectorType>       ue(u.data(),nr);
+    if(!pattern_ptr->ok){
+      ue.setConstant(std::numeric_limits<ValueType>::quiet_NaN());}
+    else{
+      std::visit([&](const auto& f){ue = f.solve(be);},data_ptr->second);}
+    stats_ptr->solved(t0);
+  }
+
+  auto operator()(const std::vector<ValueType>& b) const {
+    std::vector<ValueType> u(nr);
+    solve(b,u);
     return u;
   }
 
+  // Seconds membres multiples (colonnes de B, ou liste de vecteurs),
+  // resolus en un seul parcours des facteurs: supernoeuds de SparseLU
+  // et de SupernodalCholesky, BlockSolve pour les factorisations de
+  // Cholesky simpliciales
+  template <typename MultiVectorType>
+  void solve(const MultiVectorType& B,
+	     MultiVectorType& X) const {
+    auto t0 = FactorStatsData::ClockType::now();
+    EigenDenseType Be, Xe;
+    Copy(B,Be);
+    assert(std::size_t(Be.rows())==nc);
+    if(!pattern_ptr->ok){
+      Xe.setConstant(nr,Be.cols(),std::numeric_limits<ValueType>::quiet_NaN());}
+    else{
+      std::visit([&](const auto& f){
+	using FactorType = std::decay_t<decltype(f)>;
+	if constexpr(std::is_same_v<FactorType,LltType> ||
+		     std::is_same_v<FactorType,LdltType>){
+	  BlockSolve(f,Be,Xe);}
+	else{Xe = f.solve(Be);}
+      },data_ptr->second);}
+    Copy(Xe,X);
+    stats_ptr->solved(t0);
+  }
+
+  auto operator()(const DenseMatrix<ValueType>& B) const {
+    DenseMatrix<ValueType> X;
+    solve(B,X);
+    return X;
+  }
+
+  auto operator()(const std::vector<std::vector<ValueType>>& B) const {
+    std::vector<std::vector<ValueType>> X;
+    solve(B,X);
+    return X;
+  }
+
   auto operator*(const std::vector<ValueType>& b) const {
     return (*this)(b);}
   
 private:
-  
-  std::size_t                       nr,nc;
-  std::shared_ptr<ContainerType> data_ptr;
-  std::shared_ptr<EigenVectorType>  u_ptr;
-  std::shared_ptr<EigenVectorType>  b_ptr;
+
+  InvCooMatrix(const std::size_t& nr0,
+	       const std::size_t& nc0,
+	       const SolverType& type0):
+    nr(nr0), nc(nc0), type(type0),
+    data_ptr(std::make_shared<std::pair<SolverType,ContainerType>>()),
+    pattern_ptr(std::make_shared<PatternType>()),
+    stats_ptr(std::make_shared<FactorStatsData>())
+  {assert( nr==nc );}
+
+  void emplace(const SolverType& t){
+    auto& solver = data_ptr->second;
+    if(t==SolverType::LU  ){solver.template emplace<LuType  >();}
+    if(t==SolverType::LLT ){solver.template emplace<LltType >();}
+    if(t==SolverType::LDLT){solver.template emplace<LdltType>();}
+    if(t==SolverType::Supernodal){solver.template emplace<SupernodalType>();}
+  }
+
+  std::size_t                                              nr,nc;
+  SolverType                                                type;
+  std::shared_ptr<std::pair<SolverType,ContainerType>> data_ptr;
+  std::shared_ptr<PatternType>                         pattern_ptr;
+  std::shared_ptr<FactorStatsData>                     stats_ptr;
 
 };
 
 template <typename VALUE_TYPE>
-auto Inv(const CooMatrix<VALUE_TYPE>& A){
-  return InvCooMatrix<VALUE_TYPE>(A); }
+auto Inv(const CooMatrix<VALUE_TYPE>& A,
+	 const SolverType& type = SolverType::Auto){
+  return InvCooMatrix<VALUE_TYPE>(A,type); }
+
+template <typename VALUE_TYPE>
+auto Inv(const CsrMatrix<VALUE_TYPE>& A,
+	 const SolverType& type = SolverType::Auto){
+  return InvCooMatrix<VALUE_TYPE>(A,type); }
+
+
+//############################//
+//   Precision mixte (float)  //
+//############################//
+
+// Bilan d'une resolution avec raffinement iteratif
+struct RefinementInfo{
+  std::size_t steps     = 0;     // resolutions en simple precision
+  double      residual  = 0.;    // |b-Ax|/|b| final
+  double      backward  = 0.;    // erreur inverse |b-Ax|/(|A||x|+|b|)
+  bool        converged = false;
+};
+
+// Factorisation de A en simple precision (memoire des facteurs
+// divisee par deux) et raffinement iteratif en double precision:
+//   x_0 = 0,  x_{k+1} = x_k + F^{-1}(b - A x_k)
+// jusqu'a ce que l'erreur inverse (normes infinies)
+//   |b-Ax| / (|A||x|+|b|) <= tol,
+// au plus maxit resolutions. Par defaut (tol<=0), tol = n*eps, ce
+// qui est atteint en quelques pas si A est assez bien conditionnee
+// pour la simple precision. Sinon les iterations s'arretent des que
+// le residu ne diminue plus assez; un pas qui l'augmente est annule,
+// si bien que x est toujours le meilleur itere calcule.
+// Avec maxit = 1, l'objet applique simplement F^{-1} a un vecteur
+// double: c'est alors un preconditionneur pour le gradient conjugue.
+class MixedInvCooMatrix{
+
+public:
+
+  using ValueType  = double;
+  using ThisType   = MixedInvCooMatrix;
+  using FactorType = InvCooMatrix<float>;
+
+  MixedInvCooMatrix(const CsrMatrix<double>& A0,
+		    const SolverType& type = SolverType::Auto,
+		    const double& tol0 = 0.,
+		    const std::size_t& maxit0 = 10):
+    A(A0), tol(tol0), maxit(maxit0) {
+    assert( NbRow(A)==NbCol(A) && maxit>0 );
+    if(tol<=0.){tol = NbRow(A)*std::numeric_limits<double>::epsilon();}
+    const auto& rows = Rows(A);
+    const auto& vals = Values(A);
+    for(std::size_t j=0; j<NbRow(A); ++j){
+      double s = 0.;
+      for(std::size_t p=rows[j]; p<rows[j+1]; ++p){s += std::abs(vals[p]);}
+      normA = std::max(normA,s);}
+    CsrMatrix<float> Af(NbRow(A),NbCol(A),
+			std::make_shared<const std::vector<std::size_t>>(Rows(A)),
+			std::make_shared<const std::vector<std::size_t>>(Cols(A)));
+    std::transform(Values(A).begin(),Values(A).end(),Values(Af).begin(),
+		   [](const double& v){return float(v);});
+    F = FactorType(Af,type);
+  }
+
+  MixedInvCooMatrix(const CooMatrix<double>& A0,
+		    const SolverType& type = SolverType::Auto,
+		    const double& tol0 = 0.,
+		    const std::size_t& maxit0 = 10):
+    MixedInvCooMatrix(CsrMatrix<double>(A0),type,tol0,maxit0) {}
+
+  MixedInvCooMatrix()                                    = default;
+  MixedInvCooMatrix(const MixedInvCooMatrix&)            = default;
+  MixedInvCooMatrix(MixedInvCooMatrix&&)                 = default;
+  MixedInvCooMatrix& operator=(const MixedInvCooMatrix&) = default;
+  MixedInvCooMatrix& operator=(MixedInvCooMatrix&&)      = default;
+
+  friend std::size_t
+  NbRow(const ThisType& m){return NbRow(m.A);}
+
+  friend std::size_t
+  NbCol(const ThisType& m){return NbCol(m.A);}
+
+  friend SolverType
+  Type(const ThisType& m){return Type(m.F);}
+
+  // Statistiques du facteur en simple precision (chaque pas de
+  // raffinement compte pour une resolution)
+  friend FactorStats
+  Stats(const ThisType& m){return Stats(m.F);}
+
+  // Vecteurs de travail d'une resolution, conserves d'un appel a
+  // l'autre (cf. CGWorkspace)
+  struct Workspace{
+    std::vector<double> r, u0;
+    std::vector<float>  rf, df;
+  };
+
+  // Resolution reentrante, renvoie le nombre de pas de raffinement
+  // (avec maxit = 1, le residu n'est pas calcule). Si le premier pas
+  // est rejete, u = 0 et converged = false. Sans espace de travail
+  // explicite, des vecteurs propres a chaque thread sont utilises:
+  // aucune allocation apres le premier appel d'un thread.
+  RefinementInfo solve(const std::vector<double>& b,
+		       std::vector<double>& u,
+		       Workspace& ws) const {
+    const std::size_t n = NbRow(A);
+    assert(b.size()==n);
+    u.assign(n,0.);
+    RefinementInfo info;
+    const double nb = Norm(b);
+    if(nb==0.){info.converged = true; return info;}
+
+    auto& [r,u0,rf,df] = ws;
+    rf.resize(n); df.resize(n);
+    if(maxit>1){r.resize(n); u0.resize(n);}
+    const double nbi = NormInf(b);
+    double nr = nb, nri = nbi;
+    while(info.steps<maxit){
+      const auto& rs = info.steps==0 ? b : r;
+      std::transform(rs.begin(),rs.end(),rf.begin(),
+		     [](const double& v){return float(v);});
+      F.solve(rf,df);
+      if(maxit>1){std::copy(u.begin(),u.end(),u0.begin());}
+      for(std::size_t j=0; j<n; ++j){u[j] += df[j];}
+      if(++info.steps==1 && maxit==1){return info;}
+      Residual(b,u,r);
+      double nr1 = Norm(r);
+      if(nr1>=nr){
+	// Pas rejete: on revient a l'itere precedent
+	std::copy(u0.begin(),u0.end(),u.begin());
+	break;}
+      bool stalled = nr1>0.5*nr;
+      nr  = nr1;
+      nri = NormInf(r);
+      if(nri<=tol*(normA*NormInf(u)+nbi) || stalled){break;}
+    }
+    info.residual  = nr/nb;
+    info.backward  = nri/(normA*NormInf(u)+nbi);
+    info.converged = info.backward<=tol;
+    return info;
+  }
+
+  RefinementInfo solve(const std::vector<double>& b,
+		       std::vector<double>& u) const {
+    thread_local Workspace ws;
+    return solve(b,u,ws);
+  }
+
+  auto operator()(const std::vector<double>& b) const {
+    std::vector<double> u;
+    solve(b,u);
+    return u;
+  }
+
+  auto operator*(const std::vector<double>& b) const {
+    return (*this)(b);}
+
+private:
+
+  static double NormInf(const std::vector<double>& x){
+    double m = 0.;
+    for(const auto& xj:x){m = std::max(m,std::abs(xj));}
+    return m;
+  }
+
+  // r = b - A u
+  void Residual(const std::vector<double>& b,
+		const std::vector<double>& u,
+		std::vector<double>& r) const {
+    const auto& rows = Rows(A);
+    const auto& cols = Cols(A);
+    const auto& vals = Values(A);
+    ParallelRange(NbRow(A),[&](const std::size_t& j0,
+			       const std::size_t& j1,
+			       const std::size_t&){
+      for(std::size_t j=j0; j<j1; ++j){
+	double s = b[j];
+	for(std::size_t p=rows[j]; p<rows[j+1]; ++p){s -= vals[p]*u[cols[p]];}
+	r[j] = s;}
+    });
+  }
+
+  CsrMatrix<double>       A;
+  FactorType              F;
+  double                  normA = 0.;    // |A| (norme infinie)
+  double                  tol   = 0.;
+  std::size_t             maxit = 10;
+
+};
+
+template <typename MatrixType>
+auto MixedInv(const MatrixType& A,
+	      const SolverType& type = SolverType::Auto,
+	      const double& tol = 0.,
+	      const std::size_t& maxit = 10){
+  return MixedInvCooMatrix(A,type,tol,maxit);}
 
 
 #endif
@@ -0,0 +1,124 @@
+#ifndef DIRICHLET_HPP
+#define DIRICHLET_HPP
+
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <assert.h>
+#include "csrmatrix.hpp"
+#include "parallel.hpp"
+
+//############################//
+//  Conditions de Dirichlet   //
+//############################//
+
+// Ddl portes par le bord du maillage (ordre croissant)
+template <std::size_t DIM>
+std::vector<std::size_t> BoundaryDofs(const FeSpace<DIM>& Vh){
+
+  const auto [Gamma,tbl] = Boundary(Vh.mesh());
+  std::vector<std::size_t> dofs;
+  dofs.reserve(DIM*tbl.size());
+  for(const auto& f:tbl){
+    auto faces = Boundary(Vh[f/(DIM+1)]);
+    for(const auto& I:faces[f%(DIM+1)]){dofs.push_back(I);}
+  }
+  std::sort(dofs.begin(),dofs.end());
+  dofs.erase(std::unique(dofs.begin(),dofs.end()),dofs.end());
+  return dofs;
+}
+
+// Complementaire d'un ensemble de ddl dans {0,...,n-1}
+std::vector<std::size_t> Complement(const std::size_t& n,
+				    const std::vector<std::size_t>& dofs){
+  std::vector<bool> in(n,false);
+  for(const auto& I:dofs){in[I] = true;}
+  std::vector<std::size_t> c;
+  c.reserve(n-std::min(n,dofs.size()));
+  for(std::size_t I=0; I<n; ++I){
+    if(!in[I]){c.push_back(I);}}
+  return c;
+}
+
+// Elimination symetrique en place de u[dofs[k]] = g[k]: les lignes
+// et colonnes des ddl imposes sont annulees (diagonale conservee),
+// le second membre recoit le relevement -A(:,D)g et b[D] = A(D,D)g.
+// Le profil de A est inchange, si bien que les valeurs peuvent etre
+// reassemblees puis eliminees a nouveau.
+void Eliminate(CsrMatrix<double>& A,
+	       std::vector<double>& b,
+	       const std::vector<std::size_t>& dofs,
+	       const std::vector<double>& g){
+
+  assert(NbRow(A)==NbCol(A) && b.size()==NbRow(A));
+  assert(g.size()==dofs.size());
+  constexpr std::size_t npos = CsrMatrix<double>::npos;
+  const std::size_t n = NbRow(A);
+  std::vector<std::size_t> num(n,npos);
+  for(std::size_t k=0; k<dofs.size(); ++k){num[dofs[k]] = k;}
+
+  const auto& rows = Rows(A);
+  const auto& cols = Cols(A);
+  auto& vals = Values(A);
+  ParallelFor(n,[&](const std::size_t& j){
+    if(num[j]!=npos){
+      for(std::size_t p=rows[j]; p<rows[j+1]; ++p){
+	if(cols[p]!=j){vals[p] = 0.;}
+	else{b[j] = vals[p]*g[num[j]];}
+      }
+    }
+    else{
+      for(std::size_t p=rows[j]; p<rows[j+1]; ++p){
+	if(num[cols[p]]!=npos){
+	  b[j]   -= vals[p]*g[num[cols[p]]];
+	  vals[p] = 0.;}
+      }
+    }
+  });
+}
+
+// Systeme reduit aux ddl libres: renvoie A(I,I), b(I) - A(I,D)g
+// et la liste I des ddl libres.
+auto Reduce(const CsrMatrix<double>& A,
+	    const std::vector<double>& b,
+	    const std::vector<std::size_t>& dofs,
+	    const std::vector<double>& g){
+
+  assert(NbRow(A)==NbCol(A) && b.size()==NbRow(A));
+  assert(g.size()==dofs.size());
+  const std::size_t n = NbRow(A);
+  auto free = Complement(n,dofs);
+
+  std::vector<double> gg(n,0.);
+  for(std::size_t k=0; k<dofs.size(); ++k){gg[dofs[k]] = g[k];}
+
+  const auto& rows = Rows(A);
+  const auto& cols = Cols(A);
+  const auto& vals = Values(A);
+  std::vector<double> bI(free.size());
+  ParallelFor(free.size(),[&](const std::size_t& i){
+    std::size_t j = free[i];
+    double s = b[j];
+    for(std::size_t p=rows[j]; p<rows[j+1]; ++p){
+      s -= vals[p]*gg[cols[p]];}
+    bI[i] = s;
+  });
+
+  return std::make_tuple(Extract(A,free),bI,free);
+}
+
+// Solution complete a partir de la solution du systeme reduit
+std::vector<double> Lift(const std::size_t& n,
+			 const std::vector<std::size_t>& free,
+			 const std::vector<double>& uI,
+			 const std::vector<std::size_t>& dofs,
+			 const std::vector<double>& g){
+  assert(uI.size()==free.size() && g.size()==dofs.size());
+  std::vector<double> u(n);
+  for(std::size_t i=0; i<free.size(); ++i){u[free[i]] = uI[i];}
+  for(std::size_t k=0; k<dofs.size(); ++k){u[dofs[k]] = g[k];}
+  return u;
+}
+
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef FACTORSTATS_HPP
+#define FACTORSTATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+//############################//
+//  Statistiques des facteurs //
+//############################//
+
+// Cout d'une factorisation (ou, apres sommation, d'un ensemble de
+// factorisations, par exemple celles de tous les sous-domaines).
+// Les nombres de coefficients sont ceux effectivement stockes;
+// flops = 0 signifie que le decompte n'est pas disponible.
+struct FactorStats{
+
+  std::size_t count     = 0;   // factorisations numeriques
+  std::size_t n         = 0;   // taille des matrices
+  std::size_t nnzA      = 0;   // coefficients de A
+  std::size_t nnzF      = 0;   // coefficients des facteurs
+  double      flops     = 0.;  // factorisation numerique (derniere)
+  std::size_t memory    = 0;   // octets des facteurs
+  std::size_t peak      = 0;   // octets, facteurs + espace de travail
+  double      t_analyze = 0.;  // secondes, cumulees
+  double      t_factor  = 0.;
+  double      t_solve   = 0.;
+  std::size_t nsolve    = 0;   // resolutions (un appel a solve)
+
+  double fill() const {return nnzA>0 ? double(nnzF)/nnzA : 0.;}
+
+  FactorStats& operator+=(const FactorStats& s){
+    count     += s.count;     n      += s.n;
+    nnzA      += s.nnzA;      nnzF   += s.nnzF;
+    flops     += s.flops;     memory += s.memory;
+    peak      += s.peak;
+    t_analyze += s.t_analyze; t_factor += s.t_factor;
+    t_solve   += s.t_solve;   nsolve   += s.nsolve;
+    return *this;
+  }
+
+  friend FactorStats operator+(FactorStats s1, const FactorStats& s2){
+    return s1 += s2;}
+
+  friend std::ostream& operator<<(std::ostream& o, const FactorStats& s){
+    o << std::left;
+    o << std::setw(12) << "n"         << s.n                       << "\n";
+    o << std::setw(12) << "nnz(A)"    << s.nnzA                    << "\n";
+    o << std::setw(12) << "nnz(F)"    << s.nnzF                    << "\n";
+    o << std::setw(12) << "fill"      << s.fill()                  << "\n";
+    o << std::setw(12) << "flops"     << s.flops                   << "\n";
+    o << std::setw(12) << "memory"    << s.memory/1048576. << " Mo" << "\n";
+    o << std::setw(12) << "peak"      << s.peak/1048576.   << " Mo" << "\n";
+    o << std::setw(12) << "analyze"   << s.t_analyze       << " s"  << "\n";
+    o << std::setw(12) << "factorize" << s.t_factor        << " s"  << " (" << s.count  << ")\n";
+    o << std::setw(12) << "solve"     << s.t_solve         << " s"  << " (" << s.nsolve << ")\n";
+    return o;
+  }
+
+};
+
+// Somme des statistiques d'une collection de solveurs
+template <typename FactorType>
+FactorStats Stats(const std::vector<FactorType>& solvers){
+  FactorStats s;
+  for(const auto& f:solvers){s += Stats(f);}
+  return s;
+}
+
+// Donnees partagees par les copies d'un solveur: les resolutions,
+// reentrantes, sont comptees atomiquement.
+struct FactorStatsData{
+
+  using ClockType = std::chrono::steady_clock;
+
+  FactorStats                 stats;
+  std::atomic<std::uint64_t>  nsolve = 0;
+  std::atomic<std::uint64_t>  ns     = 0;
+
+  static double Seconds(const ClockType::time_point& t0){
+    return std::chrono::duration<double>(ClockType::now()-t0).count();}
+
+  void solved(const ClockType::time_point& t0){
+    auto dt = std::chrono::duration_cast<std::chrono::nanoseconds>(ClockType::now()-t0);
+    ++nsolve;
+    ns += dt.count();
+  }
+
+  FactorStats get() const {
+    FactorStats s = stats;
+    s.nsolve  = nsolve;
+    s.t_solve = 1e-9*ns;
+    return s;
+  }
+
+};
+
+// Nombre d'operations de Cholesky a partir des longueurs des
+// colonnes de L (diagonale comprise): sum_j c_j^2
+template <typename CountType>
+double CholeskyFlops(const std::vector<CountType>& c){
+  double fl = 0.;
+  for(const auto& cj:c){fl += double(cj)*double(cj);}
+  return fl;
+}
+
+
+#endif
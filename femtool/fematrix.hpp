@@ -1,7 +1,18 @@
 #ifndef FEMATRIX_HPP
 #define FEMATRIX_HPP
 
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <tuple>
+#include <limits>
+#include <numeric>
+#include <algorithm>
 #include "coomatrix.hpp"
+#include "csrmatrix.hpp"
+#include "parallel.hpp"
+#include "p1kernel.hpp"
+#include "geometry.hpp"
 
 
 template <std::size_t DIM>
@@ -9,53 +20,544 @@ auto Identity(const FeSpace<DIM>& Vh){
   return IdentityMatrix(dim(Vh));
 }
 
-template <std::size_t DIM>
-auto Mass(const FeSpace<DIM>& Vh){
+// Matrices elementaires des cellules elts[0..n), n<=P1Lanes.
+// local est soit une fonction par lots local(elts,n,Ae), soit une
+// fonction par cellule local(I,Ae) appelee sur chaque element.
+template <std::size_t DIM, typename LocalFctType>
+void LocalMatrices(const FeSpace<DIM>& Vh,
+		   const std::size_t* elts,
+		   const std::size_t& n,
+		   std::array<double,(DIM+1)*(DIM+1)>* Ae,
+		   LocalFctType& local){
+  using MatrixType = std::array<double,(DIM+1)*(DIM+1)>;
+  if constexpr(std::invocable<LocalFctType&,const std::size_t*,
+		              const std::size_t&,MatrixType*>){
+    local(elts,n,Ae);}
+  else{
+    for(std::size_t l=0; l<n; ++l){local(Vh[elts[l]],Ae[l]);}}
+}
+
+// Boucle sur les elements en parallele: local calcule les matrices
+// elementaires (rangees par lignes), par lots de P1Lanes cellules.
+// Chaque thread remplit ses propres triplets sur une tranche
+// contigue d'elements; les tranches sont concatenees dans l'ordre
+// des elements, si bien que le resultat ne depend pas du nombre
+// de threads.
+template <std::size_t DIM, typename LocalFctType>
+auto Assemble(const FeSpace<DIM>& Vh, LocalFctType local){
 
-  CooMatrix<double> M(dim(Vh),dim(Vh));
-  for(const auto& I:Vh){
-    double h = Vol(I.elt())/((DIM+1.)*(DIM+2.));
-    for(std::size_t j=0; j< dim(I); ++j){
-      for(std::size_t k=0; k< dim(I); ++k){
-	if(j==k){ M.push_back(I[j],I[k],2.*h); }
-	else    { M.push_back(I[j],I[k],   h); }
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  using ContainerType = typename CooMatrix<double>::ContainerType;
+
+  std::vector<ContainerType> buf(NbThread());
+  ParallelRange(Vh.size(),[&](const std::size_t& b,
+			      const std::size_t& e,
+			      const std::size_t& t){
+    auto& bt = buf[t];
+    bt.reserve((e-b)*d*d);
+    std::array<std::array<double,d*d>,P1Lanes> Ae;
+    std::array<std::size_t,P1Lanes> elts;
+    for(std::size_t j0=b; j0<e; j0+=P1Lanes){
+      std::size_t n = std::min(P1Lanes,e-j0);
+      for(std::size_t l=0; l<n; ++l){elts[l] = j0+l;}
+      LocalMatrices(Vh,elts.data(),n,Ae.data(),local);
+      for(std::size_t l=0; l<n; ++l){
+	const auto& I = Vh[j0+l];
+	for(std::size_t p=0; p<d; ++p){
+	  for(std::size_t q=0; q<d; ++q){
+	    bt.emplace_back(I[p],I[q],Ae[l][p*d+q]);}}
       }
     }
-  }
-  M.sort();
-  return M;
-  
+  });
+
+  CooMatrix<double> A(dim(Vh),dim(Vh));
+  std::size_t nnz = 0;
+  for(const auto& bt:buf){nnz += bt.size();}
+  A.reserve(nnz);
+  for(auto& bt:buf){
+    A.push_back(bt);
+    ContainerType().swap(bt);}
+  A.compress();
+  return A;
+}
+
+template <std::size_t DIM>
+auto Mass(const FeSpace<DIM>& Vh){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  return Assemble(Vh,[&Vh](const std::size_t* elts, const std::size_t& n,
+			   std::array<double,d*d>* Me){
+    P1Coords<DIM> x;
+    Lanes<P1Lanes> h;
+    P1Matrix<DIM> M;
+    P1Load<DIM>(Vh,elts,n,x);
+    P1Volume<DIM>(x,h);
+    P1Mass<DIM>(h,M);
+    P1Store<DIM>(M,n,Me);
+  });
+
 }
 
 template <std::size_t DIM>
 auto Stiffness(const FeSpace<DIM>& Vh){
   
-  CooMatrix<double> K(dim(Vh),dim(Vh));  
-  std::size_t d = FeSpace<DIM>::local_space_dim;
-  for(const auto& I:Vh){
-
-    const auto& e = I.elt();
-    auto  n = BdNormal(e);
-    auto  h = Vol(e);
-    
-    for(std::size_t j=0; j<dim(I); ++j){
-      for(std::size_t k=0; k<dim(I); ++k){
-
-	double Kjk = 0.;	
-	Kjk  = (n[j]|n[k])*h;
-	Kjk /= ((e[j]-e[(j+1)%d])|n[j]);
-	Kjk /= ((e[k]-e[(k+1)%d])|n[k]);
-	K.push_back(I[j],I[k],Kjk);
-	
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  return Assemble(Vh,[&Vh](const std::size_t* elts, const std::size_t& n,
+			   std::array<double,d*d>* Ke){
+    P1Coords<DIM> x;
+    Lanes<P1Lanes> h;
+    P1Matrix<DIM> K;
+    P1Load<DIM>(Vh,elts,n,x);
+    P1Stiffness<DIM>(x,h,K);
+    P1Store<DIM>(K,n,Ke);
+  });
+
+}
+
+// Variantes reutilisant la geometrie deja calculee
+template <std::size_t DIM>
+auto Mass(const FeSpace<DIM>& Vh, const Geometry<DIM>& geo){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  assert(geo.size()==Vh.size());
+  return Assemble(Vh,[&geo](const std::size_t* elts, const std::size_t& n,
+			    std::array<double,d*d>* Me){
+    const auto& vol = GetData(geo).vol;
+    Lanes<P1Lanes> h;
+    P1Matrix<DIM> M;
+    for(std::size_t w=0; w<P1Lanes; ++w){h[w] = vol[elts[std::min(w,n-1)]];}
+    P1Mass<DIM>(h,M);
+    P1Store<DIM>(M,n,Me);
+  });
+}
+
+template <std::size_t DIM>
+auto Stiffness(const FeSpace<DIM>& Vh, const Geometry<DIM>& geo){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  assert(geo.size()==Vh.size());
+  return Assemble(Vh,[&geo](const std::size_t* elts, const std::size_t& n,
+			    std::array<double,d*d>* Ke){
+    Lanes<P1Lanes> h;
+    P1Grad<DIM> G;
+    P1Matrix<DIM> K;
+    geo.load(elts,n,h,G);
+    P1Stiffness<DIM>(h,G,K);
+    P1Store<DIM>(K,n,Ke);
+  });
+}
+
+
+//############################//
+// Assemblage en stockage CSR //
+//############################//
+
+// Profil des matrices elements finis sur Vh
+template <std::size_t DIM>
+CsrMatrix<double> Pattern(const FeSpace<DIM>& Vh){
+
+  auto g = Adjacency(Vh);
+  std::size_t n = dim(Vh);
+  auto rows = std::make_shared<std::vector<std::size_t>>(n+1,0);
+  auto cols = std::make_shared<std::vector<std::size_t>>(g.adj.size()+n);
+  for(std::size_t j=0; j<n; ++j){
+    (*rows)[j+1] = g.offset[j+1]+j+1;}
+  ParallelFor(n,[&](const std::size_t& j){
+    auto out = cols->begin()+(*rows)[j];
+    *out = j;
+    std::copy(g.begin(j),g.end(j),out+1);
+    std::sort(out,cols->begin()+(*rows)[j+1]);});
+
+  return CsrMatrix<double>(n,n,rows,cols);
+}
+
+// Coloriage glouton des elements: deux elements de meme couleur
+// n'ont aucun ddl commun. Les elements qui ne trouvent pas de
+// couleur parmi les 64 premieres forment un dernier groupe,
+// a traiter sequentiellement.
+template <std::size_t DIM>
+std::vector<std::vector<std::size_t>> Coloring(const FeSpace<DIM>& Vh){
+
+  std::vector<std::uint64_t> used(dim(Vh),0);
+  std::vector<std::vector<std::size_t>> color(65);
+  for(std::size_t j=0; j<Vh.size(); ++j){
+    std::uint64_t mask = 0;
+    for(const auto& Ik:Vh[j]){mask |= used[Ik];}
+    std::size_t c = std::countr_one(mask);
+    if(c<64){
+      for(const auto& Ik:Vh[j]){used[Ik] |= (std::uint64_t(1)<<c);}}
+    color[c].push_back(j);
+  }
+  while(!color.empty() && color.back().empty()){color.pop_back();}
+  return color;
+}
+
+// Assemblage direct dans un profil existant: les elements d'une
+// meme couleur sont traites en parallele. Chaque coefficient recoit
+// ses contributions dans l'ordre des couleurs, si bien que le
+// resultat ne depend pas du nombre de threads.
+template <std::size_t DIM, typename LocalFctType>
+void Assemble(CsrMatrix<double>& A,
+	      const FeSpace<DIM>& Vh,
+	      const std::vector<std::vector<std::size_t>>& color,
+	      LocalFctType local){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  assert(NbRow(A)==dim(Vh) && NbCol(A)==dim(Vh));
+  auto& vals = Values(A);
+  std::fill(vals.begin(),vals.end(),0.);
+
+  for(std::size_t c=0; c<color.size(); ++c){
+    const auto& elts = color[c];
+    auto work = [&](const std::size_t& b,
+		    const std::size_t& e,
+		    const std::size_t&){
+      std::array<std::array<double,d*d>,P1Lanes> Ae;
+      for(std::size_t l0=b; l0<e; l0+=P1Lanes){
+	std::size_t n = std::min(P1Lanes,e-l0);
+	LocalMatrices(Vh,elts.data()+l0,n,Ae.data(),local);
+	for(std::size_t l=0; l<n; ++l){
+	  const auto& I = Vh[elts[l0+l]];
+	  for(std::size_t p=0; p<d; ++p){
+	    for(std::size_t q=0; q<d; ++q){
+	      std::size_t pq = A.find(I[p],I[q]);
+	      assert(pq!=A.npos);
+	      vals[pq] += Ae[l][p*d+q];}}
+	}
       }
+    };
+    if(c<64){ParallelRange(elts.size(),work);}
+    else    {work(0,elts.size(),0);}
+  }
+}
+
+template <std::size_t DIM, typename LocalFctType>
+void Assemble(CsrMatrix<double>& A,
+	      const FeSpace<DIM>& Vh,
+	      LocalFctType local){
+  Assemble(A,Vh,Coloring(Vh),local);}
+
+// Matrices elementaires de a*Stiffness + b*Mass, par lots
+template <std::size_t DIM>
+auto ReactionDiffusionKernel(const FeSpace<DIM>& Vh,
+			     const double& a,
+			     const double& b){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  return [&Vh,a,b](const std::size_t* elts, const std::size_t& n,
+		   std::array<double,d*d>* Ae){
+    P1Coords<DIM> x;
+    Lanes<P1Lanes> h;
+    P1Matrix<DIM> K,M;
+    P1Load<DIM>(Vh,elts,n,x);
+    P1Stiffness<DIM>(x,h,K);
+    P1Mass<DIM>(h,M);
+    for(std::size_t pq=0; pq<d*d; ++pq){
+      for(std::size_t w=0; w<P1Lanes; ++w){
+	K[pq][w] = a*K[pq][w]+b*M[pq][w];}}
+    P1Store<DIM>(K,n,Ae);
+  };
+}
+
+// Meme chose a partir de la geometrie deja calculee
+template <std::size_t DIM>
+auto ReactionDiffusionKernel(const Geometry<DIM>& geo,
+			     const double& a,
+			     const double& b){
+
+  constexpr std::size_t d = DIM+1;
+  return [&geo,a,b](const std::size_t* elts, const std::size_t& n,
+		    std::array<double,d*d>* Ae){
+    Lanes<P1Lanes> h;
+    P1Grad<DIM> G;
+    P1Matrix<DIM> K,M;
+    geo.load(elts,n,h,G);
+    P1Stiffness<DIM>(h,G,K);
+    P1Mass<DIM>(h,M);
+    for(std::size_t pq=0; pq<d*d; ++pq){
+      for(std::size_t w=0; w<P1Lanes; ++w){
+	K[pq][w] = a*K[pq][w]+b*M[pq][w];}}
+    P1Store<DIM>(K,n,Ae);
+  };
+}
+
+// Ajout de diag(c)
+template <typename ValueType>
+void AddDiagonal(CsrMatrix<ValueType>& A,
+		 const std::vector<ValueType>& c){
+  if(c.empty()){return;}
+  assert(c.size()==NbRow(A));
+  auto& vals = Values(A);
+  for(std::size_t j=0; j<c.size(); ++j){
+    vals[A.find(j,j)] += c[j];}
+}
+
+// Matrice a*Stiffness + b*Mass + diag(c) assemblee en une seule
+// boucle sur les elements. Les formes qui recoivent A ne mettent a
+// jour que les valeurs d'une matrice dont le profil a deja ete
+// construit; pour un balayage en (a,b), le coloriage color =
+// Coloring(Vh) est calcule une fois par l'appelant.
+template <std::size_t DIM>
+void ReactionDiffusion(CsrMatrix<double>& A,
+		       const FeSpace<DIM>& Vh,
+		       const std::vector<std::vector<std::size_t>>& color,
+		       const double& a,
+		       const double& b,
+		       const std::vector<double>& c = {}){
+  Assemble(A,Vh,color,ReactionDiffusionKernel(Vh,a,b));
+  AddDiagonal(A,c);
+}
+
+template <std::size_t DIM>
+void ReactionDiffusion(CsrMatrix<double>& A,
+		       const FeSpace<DIM>& Vh,
+		       const double& a,
+		       const double& b,
+		       const std::vector<double>& c = {}){
+  ReactionDiffusion(A,Vh,Coloring(Vh),a,b,c);}
+
+template <std::size_t DIM>
+void ReactionDiffusion(CsrMatrix<double>& A,
+		       const FeSpace<DIM>& Vh,
+		       const Geometry<DIM>& geo,
+		       const std::vector<std::vector<std::size_t>>& color,
+		       const double& a,
+		       const double& b,
+		       const std::vector<double>& c = {}){
+
+  assert(geo.size()==Vh.size());
+  Assemble(A,Vh,color,ReactionDiffusionKernel(geo,a,b));
+  AddDiagonal(A,c);
+}
+
+template <std::size_t DIM>
+void ReactionDiffusion(CsrMatrix<double>& A,
+		       const FeSpace<DIM>& Vh,
+		       const Geometry<DIM>& geo,
+		       const double& a,
+		       const double& b,
+		       const std::vector<double>& c = {}){
+  ReactionDiffusion(A,Vh,geo,Coloring(Vh),a,b,c);}
+
+template <std::size_t DIM>
+CsrMatrix<double> ReactionDiffusion(const FeSpace<DIM>& Vh,
+				    const Geometry<DIM>& geo,
+				    const double& a,
+				    const double& b,
+				    const std::vector<double>& c = {}){
+  auto A = Pattern(Vh);
+  ReactionDiffusion(A,Vh,geo,a,b,c);
+  return A;
+}
+
+template <std::size_t DIM>
+CsrMatrix<double> ReactionDiffusion(const FeSpace<DIM>& Vh,
+				    const double& a,
+				    const double& b,
+				    const std::vector<double>& c = {}){
+  auto A = Pattern(Vh);
+  ReactionDiffusion(A,Vh,a,b,c);
+  return A;
+}
+
+
+//############################//
+// Matrices locales (Neumann) //
+//############################//
+
+// Assemblage direct sur les cellules elts d'un sous-domaine, dans
+// la numerotation locale des ddl (ordre croissant des ddl globaux).
+// Renvoie la matrice locale et la correspondance local -> global.
+// Le tableau marker (taille dim(Vh), rempli de npos) est restitue
+// dans son etat initial.
+template <std::size_t DIM, typename LocalFctType>
+auto LocalAssemble(const FeSpace<DIM>& Vh,
+		   const std::vector<std::size_t>& elts,
+		   std::vector<std::size_t>& marker,
+		   LocalFctType local){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  assert(marker.size()==dim(Vh));
+
+  std::vector<std::size_t> l2g;
+  l2g.reserve(elts.size()+d);
+  for(const auto& j:elts){
+    for(const auto& Ik:Vh[j]){
+      if(marker[Ik]==npos){
+	marker[Ik] = 0;
+	l2g.push_back(Ik);}
+    }
+  }
+  std::sort(l2g.begin(),l2g.end());
+  for(std::size_t i=0; i<l2g.size(); ++i){marker[l2g[i]] = i;}
+
+  // La matrice est construite sequentiellement (on est en general
+  // dans une tache de ParallelTasks): triplets ranges par lignes dans
+  // l'ordre des elements, puis tri stable de chaque ligne et somme
+  // des doublons, comme CooMatrix::compress.
+  const std::size_t nl = l2g.size();
+  std::vector<std::size_t> pos(nl+1,0);
+  for(const auto& j:elts){
+    for(const auto& Ik:Vh[j]){pos[marker[Ik]+1] += d;}}
+  std::partial_sum(pos.begin(),pos.end(),pos.begin());
+  const std::vector<std::size_t> row(pos);
+
+  std::vector<std::pair<std::size_t,double>> kv(pos[nl]);
+  std::array<std::array<double,d*d>,P1Lanes> Ae;
+  for(std::size_t l0=0; l0<elts.size(); l0+=P1Lanes){
+    std::size_t n = std::min(P1Lanes,elts.size()-l0);
+    LocalMatrices(Vh,elts.data()+l0,n,Ae.data(),local);
+    for(std::size_t l=0; l<n; ++l){
+      const auto& I = Vh[elts[l0+l]];
+      for(std::size_t p=0; p<d; ++p){
+	auto& pp = pos[marker[I[p]]];
+	for(std::size_t q=0; q<d; ++q){
+	  kv[pp++] = {marker[I[q]],Ae[l][p*d+q]};}}
     }
   }
-  K.sort();
-  return K;
 
+  for(const auto& I:l2g){marker[I] = npos;}
+
+  auto rows = std::make_shared<std::vector<std::size_t>>(nl+1,0);
+  auto cols = std::make_shared<std::vector<std::size_t>>();
+  cols->reserve(kv.size());
+  std::vector<double> vals;
+  vals.reserve(kv.size());
+  for(std::size_t i=0; i<nl; ++i){
+    auto b = kv.begin()+row[i], e = kv.begin()+row[i+1];
+    std::stable_sort(b,e,[](const auto& x, const auto& y){
+      return x.first<y.first;});
+    for(auto it=b; it!=e; ++it){
+      if(it!=b && it->first==cols->back()){vals.back() += it->second;}
+      else{cols->push_back(it->first); vals.push_back(it->second);}
+    }
+    (*rows)[i+1] = cols->size();
+  }
+
+  CsrMatrix<double> A(nl,nl,rows,cols);
+  std::copy(vals.begin(),vals.end(),Values(A).begin());
+  return std::make_tuple(A,l2g);
 }
 
+// Tous les sous-domaines, traites en parallele
+template <std::size_t DIM, typename LocalFctType>
+auto LocalAssemble(const FeSpace<DIM>& Vh,
+		   const std::vector<std::vector<std::size_t>>& parts,
+		   LocalFctType local){
+
+  using LocalType = std::tuple<CsrMatrix<double>,std::vector<std::size_t>>;
+  std::vector<LocalType> loc(parts.size());
+  std::vector<std::vector<std::size_t>> marker(NbThread());
 
+  ParallelTasks(parts.size(),
+		[&](const std::size_t& p, const std::size_t& t){
+		  if(marker[t].empty()){
+		    marker[t].assign(dim(Vh),
+				     std::numeric_limits<std::size_t>::max());}
+		  loc[p] = LocalAssemble(Vh,parts[p],marker[t],local);
+		});
+  return loc;
+}
+
+// Matrices de Neumann a*Stiffness + b*Mass des sous-domaines
+template <std::size_t DIM>
+auto LocalReactionDiffusion(const FeSpace<DIM>& Vh,
+			    const std::vector<std::vector<std::size_t>>& parts,
+			    const double& a,
+			    const double& b){
+  return LocalAssemble(Vh,parts,ReactionDiffusionKernel(Vh,a,b));}
+
+template <std::size_t DIM>
+auto LocalReactionDiffusion(const FeSpace<DIM>& Vh,
+			    const Geometry<DIM>& geo,
+			    const std::vector<std::vector<std::size_t>>& parts,
+			    const double& a,
+			    const double& b){
+  assert(geo.size()==Vh.size());
+  return LocalAssemble(Vh,parts,ReactionDiffusionKernel(geo,a,b));}
+
+
+//############################//
+//   Termes de bord (Robin)   //
+//############################//
+
+// Faces de bord codees elt*(DIM+1)+face, comme dans Boundary(mesh)
+template <std::size_t DIM>
+std::vector<std::size_t> BoundaryFacets(const FeSpace<DIM>& Vh){
+  return std::get<1>(Boundary(Vh.mesh()));}
+
+// Matrices de masse des faces, calculees en parallele, puis
+// sommees dans l'ordre des faces: le resultat ne depend pas
+// du nombre de threads.
+template <std::size_t DIM, typename ScatterType>
+void BoundaryMass(const FeSpace<DIM>& Vh,
+		  const std::vector<std::size_t>& facets,
+		  ScatterType scatter){
+
+  static_assert(DIM>=1);
+  constexpr std::size_t d = DIM;
+
+  // En 1D, une face est un point: masse de Dirac
+  if constexpr(DIM==1){
+    for(const auto& f:facets){
+      auto faces = Boundary(Vh[f/2]);
+      scatter(faces[f%2][0],faces[f%2][0],1.);}
+  }
+  else{
+    std::vector<double> h(facets.size());
+    ParallelFor(facets.size(),[&](const std::size_t& f){
+      auto faces = Boundary(Vh[facets[f]/(DIM+1)].elt());
+      h[f] = Vol(faces[facets[f]%(DIM+1)])/(d*(d+1.));
+    });
+
+    for(std::size_t f=0; f<facets.size(); ++f){
+      auto faces = Boundary(Vh[facets[f]/(DIM+1)]);
+      const auto& I = faces[facets[f]%(DIM+1)];
+      for(std::size_t p=0; p<d; ++p){
+	for(std::size_t q=0; q<d; ++q){
+	  scatter(I[p],I[q],(p==q ? 2.*h[f] : h[f]));}}
+    }
+  }
+}
+
+// Masse de bord dans la numerotation de Vh (remplace B^T Mass(Wh) B)
+template <std::size_t DIM>
+CooMatrix<double> BoundaryMass(const FeSpace<DIM>& Vh,
+			       const std::vector<std::size_t>& facets){
+  CooMatrix<double> A(dim(Vh),dim(Vh));
+  A.reserve(DIM*DIM*facets.size());
+  BoundaryMass(Vh,facets,[&A](const std::size_t& j, const std::size_t& k,
+			      const double& v){A.push_back(j,k,v);});
+  A.compress();
+  return A;
+}
+
+template <std::size_t DIM>
+CooMatrix<double> BoundaryMass(const FeSpace<DIM>& Vh){
+  return BoundaryMass(Vh,BoundaryFacets(Vh));}
+
+// A += alpha*BoundaryMass, directement dans le profil de A
+// (toute face est contenue dans un element de Vh)
+template <std::size_t DIM>
+void AddBoundaryMass(CsrMatrix<double>& A,
+		     const FeSpace<DIM>& Vh,
+		     const std::vector<std::size_t>& facets,
+		     const double& alpha){
+  assert(NbRow(A)==dim(Vh) && NbCol(A)==dim(Vh));
+  auto& vals = Values(A);
+  BoundaryMass(Vh,facets,[&](const std::size_t& j, const std::size_t& k,
+			     const double& v){
+    std::size_t jk = A.find(j,k);
+    assert(jk!=A.npos);
+    vals[jk] += alpha*v;});
+}
+
+template <std::size_t DIM>
+void AddBoundaryMass(CsrMatrix<double>& A,
+		     const FeSpace<DIM>& Vh,
+		     const double& alpha){
+  AddBoundaryMass(A,Vh,BoundaryFacets(Vh),alpha);}
 
 
 #endif
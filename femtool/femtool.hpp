@@ -3,13 +3,25 @@
 
 #include "smallvector.hpp"
 #include "vectorops.hpp"
+#include "parallel.hpp"
 #include "element.hpp"
 #include "nodes.hpp"
 #include "mesh.hpp"
+#include "meshgenerator.hpp"
 #include "densematrix.hpp"
 #include "coomatrix.hpp"
+#include "csrmatrix.hpp"
 #include "fespace.hpp"
+#include "renumbering.hpp"
+#include "ordering.hpp"
+#include "p1kernel.hpp"
+#include "geometry.hpp"
+#include "quadrature.hpp"
 #include "fematrix.hpp"
+#include "dirichlet.hpp"
+#include "submesh.hpp"
+#include "cholesky.hpp"
+#include "factorstats.hpp"
 #include "directsolver.hpp"
 #include "iterativesolver.hpp"
 #include "preconditioner.hpp"
@@ -7,7 +7,13 @@
 #include <assert.h>
 #include <filesystem>
 #include <type_traits>
+#include <limits>
+#include <span>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include "element.hpp"
+#include "parallel.hpp"
 
 //###########################//
 //   Cellule element fini    //
@@ -133,39 +139,89 @@ public:
   using EltType       = Element<DIM>;
   using MeshType      = Mesh   <DIM>;
   using DataContainer = std::vector<CellType>;
+  using PointContainer = std::vector<R3>;
 
   static constexpr std::size_t geometry_dim    = DIM;
   static constexpr std::size_t local_space_dim = CellType::space_dim;
   static constexpr std::size_t value_dim       = CellType::value_dim;
   
-  FeSpace(const MeshType& mesh0 = MeshType()):
+  // Les ddl suivent l'ordre des sommets du maillage, ou l'ordre
+  // donne par perm (perm[nouveau] = ancien) s'il est fourni.
+  FeSpace(const MeshType& mesh0 = MeshType(),
+	  const std::vector<std::size_t>& perm = {}):
     data_ptr(std::make_shared<DataContainer>(mesh0.size())),
+    points_ptr(std::make_shared<PointContainer>()),
     mesh_(mesh0), space_dim(0)
   {
     attach(mesh_);
-    
-    std::size_t d = local_space_dim;
-    std::vector<std::tuple<const R3*, std::size_t>> tbl;
-    tbl.reserve(d*size());
-
-    for(std::size_t j=0; j<size(); ++j){
+    if(size()==0){return;}
+
+    constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+    constexpr std::size_t d = local_space_dim;
+    const auto v  = mesh_.nodes();
+    const std::size_t ne = size();
+
+    // Cle de chaque sommet: son indice dans mesh_.nodes(), ou son
+    // adresse s'il n'y figure pas (l'ordre des cles est dans les deux
+    // cas celui des adresses, comme pour l'ancienne numerotation)
+    const R3* v0 = v.size()>0 ? &v[0] : nullptr;
+    std::less_equal<const R3*> le;
+    std::atomic<bool> inside = true;
+    std::vector<std::size_t> key(d*ne);
+    ParallelFor(ne,[&](const std::size_t& j){
       for(std::size_t k=0; k<d; ++k){
-	tbl.push_back({ &(mesh_[j][k]), k+j*d });
-      }
+	const R3* p = &mesh_[j][k];
+	if(v0 && le(v0,p) && le(p,v0+v.size()-1)){key[j*d+k] = p-v0;}
+	else{inside = false;}
+      }});
+    if(!inside){
+      assert(perm.empty());
+      for(std::size_t j=0; j<ne; ++j){
+	for(std::size_t k=0; k<d; ++k){
+	  key[j*d+k] = reinterpret_cast<std::uintptr_t>(&mesh_[j][k]);}}
     }
-    std::sort(tbl.begin(),tbl.end());
-
-    if(size()>0){
-      auto [p0,jk0] = tbl[0];
-      for(const auto& [p,jk]:tbl){
-	if(p>p0){
-	  p0=p;
-	  ++space_dim;
-	}
-	(*data_ptr)[jk/d][jk%d] = space_dim;
+
+    // Numerotation des ddl: table dense sur [lo,hi] si l'intervalle
+    // des cles est court (ou si perm est donne), tri sinon, si bien
+    // que le cout est celui du maillage et non de l'ensemble des
+    // noeuds eventuellement partage avec d'autres maillages.
+    auto [lo,hi] = std::minmax_element(key.begin(),key.end());
+    const std::size_t k0 = perm.empty() ? *lo : 0;
+    const std::size_t nk = perm.empty() ? *hi-*lo+1 : v.size();
+    auto& data = *data_ptr;
+    if(nk<=4*key.size()){
+      std::vector<std::size_t> num(nk,npos);
+      for(const auto& K:key){num[K-k0] = 0;}
+      if(perm.empty()){
+	for(auto& n:num){
+	  if(n!=npos){n = space_dim++;}}
+      }
+      else{
+	assert(perm.size()==v.size());
+	for(const auto& I:perm){
+	  if(num[I]!=npos){num[I] = space_dim++;}}
       }
-      ++space_dim;
+      ParallelFor(ne,[&](const std::size_t& j){
+	for(std::size_t k=0; k<d; ++k){
+	  data[j][k] = num[key[j*d+k]-k0];}});
     }
+    else{
+      std::vector<std::size_t> used(key);
+      std::sort(used.begin(),used.end());
+      used.erase(std::unique(used.begin(),used.end()),used.end());
+      space_dim = used.size();
+      ParallelFor(ne,[&](const std::size_t& j){
+	for(std::size_t k=0; k<d; ++k){
+	  data[j][k] = std::lower_bound(used.begin(),used.end(),key[j*d+k])
+	    -used.begin();}});
+    }
+
+    // Coordonnees des ddl, conservees pour l'interpolation
+    auto& x = *points_ptr;
+    x.resize(space_dim);
+    for(std::size_t j=0; j<ne; ++j){
+      for(std::size_t k=0; k<d; ++k){
+	x[data[j][k]] = mesh_[j][k];}}
   }
   
   FeSpace(const FeSpace&)            = default;
@@ -209,32 +265,75 @@ public:
     return o;
   }
 
-  friend auto
+  friend const PointContainer&
   Points(const FeSpace& Vh){
-    std::vector<R3> x(dim(Vh));
-    for(std::size_t j=0; j<Vh.size(); ++j){
-      auto xj = Points(Vh[j]);
-      for(std::size_t k=0; k<xj.size(); ++k){
-	x[Vh[j][k]]=xj[k];
-      }
-    }
-    return x;
-  }
-    
-  template <typename FctType> 
-  auto operator()(FctType fct) const {    
+    return *Vh.points_ptr;}
+
+  // Interpolation nodale, fct est evaluee sequentiellement dans
+  // l'ordre des ddl. Vh(Parallel,fct) l'evalue en parallele.
+  template <typename FctType>
+  requires std::invocable<FctType,const R3&>
+  auto operator()(FctType fct) const {
     std::vector<std::invoke_result_t<FctType,R3>> v(space_dim);
-    auto x = Points(*this);
-    for(std::size_t j=0; j<space_dim; ++j){
-      v[j]=fct(x[j]);}
+    const auto& x = *points_ptr;
+    for(std::size_t j=0; j<space_dim; ++j){v[j] = fct(x[j]);}
+    return v;
+  }
+
+  template <typename FctType>
+  requires std::invocable<const FctType&,const R3&>
+  auto operator()(ParallelTag, const FctType& fct) const {
+    using ValueType = std::invoke_result_t<const FctType&,R3>;
+    static_assert(!std::is_same_v<ValueType,bool>);
+    std::vector<ValueType> v(space_dim);
+    const auto& x = *points_ptr;
+    ParallelFor(space_dim,[&](const std::size_t& j){v[j] = fct(x[j]);});
+    return v;
+  }
+
+  // Interpolation par blocs: fct(x,v) remplit v[p] = f(x[p])
+  // pour un bloc contigu de points x (meme alternative)
+  template <typename FctType>
+  requires std::invocable<FctType,std::span<const R3>,std::span<double>>
+  auto operator()(FctType fct,
+		  const std::size_t& block = 256) const {
+    std::vector<double> v(space_dim);
+    for(std::size_t b=0; b<nblock(block); ++b){apply(fct,block,b,v);}
+    return v;
+  }
+
+  template <typename FctType>
+  requires std::invocable<const FctType&,std::span<const R3>,std::span<double>>
+  auto operator()(ParallelTag,
+		  const FctType& fct,
+		  const std::size_t& block = 256) const {
+    std::vector<double> v(space_dim);
+    ParallelFor(nblock(block),[&](const std::size_t& b){
+      apply(fct,block,b,v);},1);
     return v;
   }
-    
+
 private:
 
-  std::shared_ptr<DataContainer> data_ptr;
-  MeshType                          mesh_;
-  std::size_t                   space_dim;
+  std::size_t nblock(const std::size_t& block) const {
+    return (space_dim+block-1)/block;}
+
+  template <typename FctType>
+  void apply(FctType& fct,
+	     const std::size_t& block,
+	     const std::size_t& b,
+	     std::vector<double>& v) const {
+    const auto& x = *points_ptr;
+    std::size_t p0 = b*block;
+    std::size_t n  = std::min(block,space_dim-p0);
+    fct(std::span<const R3>(x.data()+p0,n),
+	std::span<double>(v.data()+p0,n));
+  }
+
+  std::shared_ptr<DataContainer>    data_ptr;
+  std::shared_ptr<PointContainer> points_ptr;
+  MeshType                             mesh_;
+  std::size_t                      space_dim;
   
 };
 
@@ -0,0 +1,140 @@
+#ifndef GEOMETRY_HPP
+#define GEOMETRY_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <assert.h>
+#include "parallel.hpp"
+#include "p1kernel.hpp"
+
+//############################//
+//  Geometrie des elements    //
+//############################//
+
+// Mesure, gradients P1 et centre de chaque element, calcules une
+// fois pour toutes (en parallele) et stockes composante par
+// composante: grad[3*k+c][j] est la composante c du gradient de
+// la k-ieme fonction de forme sur l'element j.
+template <std::size_t DIM>
+class Geometry{
+
+public:
+
+  using MeshType       = Mesh<DIM>;
+  using ValueContainer = std::vector<double>;
+
+  static constexpr std::size_t local_dim = DIM+1;
+
+  struct DataType{
+    ValueContainer                              vol;
+    std::array<ValueContainer,3*(DIM+1)>       grad;
+    std::array<ValueContainer,3>                ctr;
+  };
+
+  Geometry(const MeshType& mesh0 = MeshType()):
+    data_ptr(std::make_shared<DataType>()), mesh_(mesh0) {
+
+    constexpr std::size_t d = DIM+1;
+    constexpr std::size_t W = P1Lanes;
+    const std::size_t ne = mesh_.size();
+    auto& data = *data_ptr;
+    data.vol.resize(ne);
+    for(auto& g:data.grad){g.resize(ne);}
+    for(auto& c:data.ctr ){c.resize(ne);}
+
+    ParallelRange(ne,[&](const std::size_t& b,
+			 const std::size_t& e,
+			 const std::size_t&){
+      P1Coords<DIM> x;
+      P1Grad<DIM>   G;
+      Lanes<W>      h;
+      std::array<std::size_t,W> elts;
+      for(std::size_t j0=b; j0<e; j0+=W){
+	std::size_t n = std::min(W,e-j0);
+	for(std::size_t w=0; w<n; ++w){elts[w] = j0+w;}
+	P1Load<DIM>(mesh_,elts.data(),n,x);
+	P1Gradients<DIM>(x,h,G);
+	for(std::size_t w=0; w<n; ++w){
+	  data.vol[j0+w] = h[w];
+	  for(std::size_t k=0; k<d; ++k){
+	    for(std::size_t c=0; c<3; ++c){
+	      data.grad[3*k+c][j0+w] = G[k][c][w];}}
+	  for(std::size_t c=0; c<3; ++c){
+	    double s = 0.;
+	    for(std::size_t k=0; k<d; ++k){s += x[k][c][w];}
+	    data.ctr[c][j0+w] = s/d;}
+	}
+      }
+    });
+  }
+
+  Geometry(const Geometry&)            = default;
+  Geometry(Geometry&&)                 = default;
+  Geometry& operator=(const Geometry&) = default;
+  Geometry& operator=(Geometry&&)      = default;
+
+  std::size_t size() const {return data_ptr->vol.size();}
+
+  auto mesh() const {return mesh_;}
+
+  double vol(const std::size_t& j) const {
+    return data_ptr->vol[j];}
+
+  R3 grad(const std::size_t& j, const std::size_t& k) const {
+    const auto& g = data_ptr->grad;
+    return R3{g[3*k][j],g[3*k+1][j],g[3*k+2][j]};}
+
+  R3 ctr(const std::size_t& j) const {
+    const auto& c = data_ptr->ctr;
+    return R3{c[0][j],c[1][j],c[2][j]};}
+
+  friend const DataType& GetData(const Geometry& g){
+    return *g.data_ptr;}
+
+  // Chargement par lots pour les noyaux P1
+  template <std::size_t W>
+  void load(const std::size_t* elts,
+	    const std::size_t& n,
+	    Lanes<W>& h,
+	    P1Grad<DIM,W>& G) const {
+    assert(n>0 && n<=W);
+    const auto& data = *data_ptr;
+    for(std::size_t w=0; w<W; ++w){
+      std::size_t j = elts[std::min(w,n-1)];
+      h[w] = data.vol[j];
+      for(std::size_t k=0; k<DIM+1; ++k){
+	for(std::size_t c=0; c<3; ++c){
+	  G[k][c][w] = data.grad[3*k+c][j];}}
+    }
+  }
+
+private:
+
+  std::shared_ptr<DataType>  data_ptr;
+  MeshType                      mesh_;
+
+};
+
+
+// Gradient (constant par element) d'une fonction P1 de Vh
+template <std::size_t DIM>
+std::vector<R3> Gradient(const Geometry<DIM>& geo,
+			 const FeSpace<DIM>& Vh,
+			 const std::vector<double>& u){
+
+  assert(geo.size()==Vh.size() && u.size()==dim(Vh));
+  const auto& grad = GetData(geo).grad;
+  std::vector<R3> du(Vh.size());
+  ParallelFor(Vh.size(),[&](const std::size_t& j){
+    const auto& I = Vh[j];
+    for(std::size_t c=0; c<3; ++c){
+      double s = 0.;
+      for(std::size_t k=0; k<DIM+1; ++k){s += u[I[k]]*grad[3*k+c][j];}
+      du[j][c] = s;}
+  });
+  return du;
+}
+
+
+#endif
@@ -5,49 +5,386 @@
 #include <cassert>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <string>
 #include <type_traits>
 #include <vector>
+#include <utility>
+#include <concepts>
+#include <cmath>
+#include <algorithm>
+#include "coomatrix.hpp"
+#include "csrmatrix.hpp"
+#include "parallel.hpp"
 
+//############################//
+//      Noyaux fusionnes      //
+//############################//
+
+// Les produits scalaires sont calcules par blocs de taille fixe,
+// puis sommes dans l'ordre des blocs: le resultat ne depend pas du
+// nombre de threads. Les sommes partielles sont rangees dans un
+// tableau fourni par l'appelant (aucune allocation).
+// Chaque thread recoit au moins StreamGrain blocs: en dessous, une
+// region parallele coute plus cher que le parcours lui-meme.
+constexpr std::size_t ReductionBlock = 4096;
+constexpr std::size_t StreamGrain    = 8;
+
+std::size_t NbReductionBlock(const std::size_t& n){
+  return (n+ReductionBlock-1)/ReductionBlock;}
+
+// fct(b,e) renvoie la contribution de [b,e)
+template <typename FctType>
+double BlockSum(const std::size_t& n,
+		std::vector<double>& partial,
+		FctType fct){
+  const std::size_t nb = NbReductionBlock(n);
+  assert(partial.size()>=nb);
+  ParallelFor(nb,[&](const std::size_t& k){
+    partial[k] = fct(k*ReductionBlock,std::min(n,(k+1)*ReductionBlock));},
+    StreamGrain);
+  double s = 0.;
+  for(std::size_t k=0; k<nb; ++k){s += partial[k];}
+  return s;
+}
+
+// (x|y)
+double Dot(const std::vector<double>& x,
+	   const std::vector<double>& y,
+	   std::vector<double>& partial){
+  return BlockSum(x.size(),partial,[&](const std::size_t& b,
+				       const std::size_t& e){
+    double s = 0.;
+    for(std::size_t j=b; j<e; ++j){s += x[j]*y[j];}
+    return s;});
+}
+
+
+//############################//
+//  Operateurs et precond.    //
+//############################//
+
+// Point de personnalisation y = A x (y deja dimensionne, ecrase):
+//  - matrices COO et CSR;
+//  - objets dotes d'une methode solve(x,y) reentrante (InvCooMatrix,
+//    CholeskyPrec, MixedInvCooMatrix, ...): y = A^{-1} x;
+//  - fonctions ou lambdas f(x,y) (operateurs sans matrice).
+void Apply(const CooMatrix<double>& A,
+	   const std::vector<double>& x,
+	   std::vector<double>& y){
+  A(x.data(),y.data());}
+
+void Apply(const CsrMatrix<double>& A,
+	   const std::vector<double>& x,
+	   std::vector<double>& y){
+  std::fill(y.begin(),y.end(),0.);
+  A(x,y);}
+
+template <typename OpType>
+requires requires(const OpType& A,
+		  const std::vector<double>& x,
+		  std::vector<double>& y){A.solve(x,y);} ||
+  std::invocable<const OpType&,const std::vector<double>&,std::vector<double>&>
+void Apply(const OpType& A,
+	   const std::vector<double>& x,
+	   std::vector<double>& y){
+  if constexpr(requires{A.solve(x,y);}){A.solve(x,y);}
+  else{A(x,y);}
+}
+
+// Preconditionneur identite (gradient conjugue simple)
+struct IdentityPrec{};
+
+void Apply(const IdentityPrec&,
+	   const std::vector<double>& x,
+	   std::vector<double>& y){
+  std::copy(x.begin(),x.end(),y.begin());}
+
+template <typename OpType>
+concept VectorOperator = requires(const OpType& A,
+				  const std::vector<double>& x,
+				  std::vector<double>& y){Apply(A,x,y);};
+
+// Ap = A p, renvoie (p|Ap)
+template <VectorOperator OpType>
+double ApplyDot(const OpType& A,
+		const std::vector<double>& p,
+		std::vector<double>& Ap,
+		std::vector<double>& partial){
+  Apply(A,p,Ap);
+  return Dot(p,Ap,partial);
+}
+
+double ApplyDot(const CooMatrix<double>& A,
+		const std::vector<double>& p,
+		std::vector<double>& Ap,
+		std::vector<double>& partial){
+  A(p.data(),Ap.data());
+  return Dot(p,Ap,partial);
+}
+
+double ApplyDot(const CsrMatrix<double>& A,
+		const std::vector<double>& p,
+		std::vector<double>& Ap,
+		std::vector<double>& partial){
+  const auto& rows = Rows(A);
+  const auto& cols = Cols(A);
+  const auto& vals = Values(A);
+  return BlockSum(p.size(),partial,[&](const std::size_t& b,
+				       const std::size_t& e){
+    double s = 0.;
+    for(std::size_t j=b; j<e; ++j){
+      double y = 0.;
+      for(std::size_t q=rows[j]; q<rows[j+1]; ++q){y += vals[q]*p[cols[q]];}
+      Ap[j] = y;
+      s    += p[j]*y;}
+    return s;});
+}
+
+// x += alpha p, r -= alpha Ap, renvoie |r|^2 (un seul parcours)
+double UpdateNorm2(const double& alpha,
+		   const std::vector<double>& p,
+		   const std::vector<double>& Ap,
+		   std::vector<double>& x,
+		   std::vector<double>& r,
+		   std::vector<double>& partial){
+  return BlockSum(x.size(),partial,[&](const std::size_t& b,
+				       const std::size_t& e){
+    double s = 0.;
+    for(std::size_t j=b; j<e; ++j){
+      x[j] += alpha*p[j];
+      r[j] -= alpha*Ap[j];
+      s    += r[j]*r[j];}
+    return s;});
+}
+
+// p = z + beta p
+void Direction(const double& beta,
+	       const std::vector<double>& z,
+	       std::vector<double>& p){
+  ParallelRange(p.size(),[&](const std::size_t& b,
+			     const std::size_t& e,
+			     const std::size_t&){
+    for(std::size_t j=b; j<e; ++j){p[j] = z[j]+beta*p[j];}},
+    StreamGrain*ReductionBlock);
+}
+
+
+//############################//
+//  Controle des iterations   //
+//############################//
+
+// Norme du residu utilisee pour l'arret: euclidienne |r|, ou
+// preconditionnee (r|Qr)^{1/2}, obtenue sans cout supplementaire
+enum class NormType{Residual,Preconditioned};
+
+// Etat transmis au moniteur (references valides pendant l'appel)
+struct IterationState{
+  std::size_t                 iter;
+  double                      residual;  // dans la norme choisie
+  double                      energy;    // |x*-x0|_A^2 - |x*-x|_A^2
+  const std::vector<double>&  x;
+  const std::vector<double>&  r;         // b - A x
+};
+
+// energy = sum alpha_k (r_k|z_k) (Hestenes-Stiefel) donne sans
+// cout la decroissance de l'erreur en norme d'energie.
+// Arret des que |r| <= max(atol, rtol |b|) (normes de type norm),
+// ou apres maxit iterations. Le moniteur et l'historique ne sont
+// sollicites que toutes les sampling iterations (jamais si 0);
+// le moniteur peut interrompre la resolution en renvoyant false.
+struct SolverControl{
+  double                                      rtol       = 1e-8;
+  double                                      atol       = 0.;
+  std::size_t                                 maxit      = 1000;
+  bool                                        zero_guess = true;
+  NormType                                    norm       = NormType::Residual;
+  std::size_t                                 sampling   = 0;
+  bool                                        history    = false;
+  std::function<bool(const IterationState&)> monitor;
+};
+
+struct SolverReport{
+  std::size_t                                    niter     = 0;
+  double                                         residual  = 0.;    // relatif
+  bool                                           converged = false;
+  std::vector<std::pair<std::size_t,double>>     history;           // (iter,residu)
+};
+
+// Ecriture de l'historique en une seule fois
+void Write(const std::vector<std::pair<std::size_t,double>>& history,
+	   const std::string& filename){
+  std::ofstream f(filename);
+  for(const auto& [it,res]:history){f << it << " ; " << res << "\n";}
+}
+
+void Write(const SolverReport& rep,
+	   const std::string& filename){
+  Write(rep.history,filename);}
+
+
+//############################//
+//    Gradient conjugue       //
+//############################//
+
+// Vecteurs de travail, conserves d'une resolution a l'autre
+// (z n'est utilise qu'avec un preconditionneur)
+struct CGWorkspace{
+
+  std::vector<double> r, z, p, Ap, partial;
+
+  void resize(const std::size_t& n, const bool& precond = true){
+    r.resize(n); p.resize(n); Ap.resize(n);
+    z.resize(precond ? n : 0);
+    partial.resize(NbReductionBlock(n));}
+
+};
+
+// Gradient conjugue preconditionne, en place (x est le point de
+// depart si ctl.zero_guess est faux). Une iteration coute une
+// application de A (fusionnee avec (p|Ap) pour les matrices CSR),
+// une de Q et trois parcours des vecteurs (deux sans
+// preconditionneur); le suivi n'ajoute qu'un test par iteration.
+template <VectorOperator OpType, VectorOperator PrecType>
+SolverReport PCG(const OpType& A,
+		 const std::vector<double>& b,
+		 std::vector<double>& x,
+		 const PrecType& Q,
+		 CGWorkspace& ws,
+		 const SolverControl& ctl = SolverControl()){
+
+  constexpr bool precond = !std::is_same_v<PrecType,IdentityPrec>;
+  const std::size_t n = b.size();
+  const bool pnorm = precond && ctl.norm==NormType::Preconditioned;
+  ws.resize(n,precond);
+  auto& [r,z0,p,Ap,partial] = ws;
+  const auto& z = precond ? z0 : r;
+  x.resize(n);
+  if(ctl.zero_guess){std::fill(x.begin(),x.end(),0.);}
+
+  // Norme de reference |b|
+  const double bb = Dot(b,b,partial);
+  double b2 = bb;
+  if(pnorm){
+    Apply(Q,b,z0);
+    b2 = Dot(b,z,partial);}
+  const double nb  = std::sqrt(b2);
+  const double eps = std::max(ctl.atol,ctl.rtol*nb);
+
+  double r2 = bb;
+  if(ctl.zero_guess){std::copy(b.begin(),b.end(),r.begin());}
+  else{
+    ApplyDot(A,x,Ap,partial);
+    r2 = BlockSum(n,partial,[&](const std::size_t& j0,
+				const std::size_t& j1){
+      double s = 0.;
+      for(std::size_t j=j0; j<j1; ++j){
+	r[j] = b[j]-Ap[j];
+	s   += r[j]*r[j];}
+      return s;});
+  }
+  double rz = r2;
+  if constexpr(precond){
+    if(ctl.zero_guess && pnorm){rz = b2;}  // z = Q b deja calcule
+    else{
+      Apply(Q,r,z0);
+      rz = Dot(r,z,partial);}
+  }
+  std::copy(z.begin(),z.end(),p.begin());
+
+  SolverReport rep;
+  auto res = [&](){return std::sqrt(pnorm ? rz : r2);};
+  const bool sample = ctl.sampling>0 && (ctl.history || ctl.monitor);
+  if(ctl.history && ctl.sampling>0){
+    rep.history.reserve(ctl.maxit/ctl.sampling+1);
+    rep.history.emplace_back(0,res());}
+
+  std::size_t niter = 0;
+  double energy = 0.;
+  bool stop = res()<=eps;
+  while( !stop && niter<ctl.maxit ){
+    ++niter;
+    double pAp   = ApplyDot(A,p,Ap,partial);
+    double alpha = rz/pAp;
+    r2 = UpdateNorm2(alpha,p,Ap,x,r,partial);
+    double rznew = r2;
+    if constexpr(precond){
+      Apply(Q,r,z0);
+      rznew = Dot(r,z,partial);}
+    Direction(rznew/rz,z,p);
+    energy += alpha*rz;
+    rz = rznew;
+    stop = res()<=eps;
+
+    if(sample && niter%ctl.sampling==0){
+      if(ctl.history){rep.history.emplace_back(niter,res());}
+      if(ctl.monitor && !ctl.monitor(IterationState{niter,res(),energy,x,r})){break;}
+    }
+  }
+
+  rep.niter     = niter;
+  rep.residual  = nb>0 ? res()/nb : res();
+  rep.converged = res()<=eps;
+  return rep;
+}
+
+template <VectorOperator OpType>
+SolverReport cgsolve(const OpType& A,
+		     const std::vector<double>& b,
+		     std::vector<double>& x,
+		     CGWorkspace& ws,
+		     const SolverControl& ctl = SolverControl()){
+  return PCG(A,b,x,IdentityPrec(),ws,ctl);}
+
+// Resolution depuis x0 (x = 0 si x0 est vide): renvoie la solution
+// et le nombre d'iterations
+template <VectorOperator OpType, VectorOperator PrecType>
+std::pair<std::vector<double>,std::size_t>
+PCGSolver(const OpType& A,
+	  const std::vector<double>& b,
+	  const PrecType& Q,
+	  SolverControl ctl = SolverControl(),
+	  const std::vector<double>& x0 = {}){
+  std::vector<double> x = x0;
+  ctl.zero_guess = x0.empty();
+  CGWorkspace ws;
+  auto rep = PCG(A,b,x,Q,ws,ctl);
+  return std::make_pair(x,rep.niter);
+}
+
+template <VectorOperator OpType, VectorOperator PrecType>
+std::pair<std::vector<double>,std::size_t>
+PCGSolver(const OpType& A,
+	  const std::vector<double>& b,
+	  const PrecType& Q,
+	  const double& tol,
+	  const std::size_t& maxit = 1000){
+  SolverControl ctl;
+  ctl.rtol  = tol;
+  ctl.maxit = maxit;
+  return PCGSolver(A,b,Q,ctl);
+}
+
+// Le critere historique |r|^2 <= 1e-8 |b|^4 correspond a
+// |r| <= 1e-4 |b| |b|; la norme du residu est affichee toutes
+// les 50 iterations.
 std::vector<double>
 cgsolve(const CooMatrix<double>&   A,
 	const std::vector<double>& b) {
-    
-  assert((NbCol(A)==NbRow(A)) &&
-	 (b.size()==NbCol(A)) );
- 
-  auto    x   = std::vector<double>(b.size(),0.);
-  auto    r   = b-A*x;
-  auto    p   = r;
-  auto   Ap   = A*p;    
-  double r2   = std::pow(Norm(r),2);  
-  double eps2 = (1e-8)*r2;
-  eps2       *= std::abs((b|b));      
-  double alpha,beta,pAp;
-    
-  std::size_t niter = 0;    
-  while( r2>eps2 && niter++<1000 ){
-      
-    Ap    = A*p;
-    pAp   = std::real((Ap|p));    
-    alpha = r2/pAp;
-    x    += alpha*p;
-    r    -= alpha*Ap;    
-    r2    = std::pow(Norm(r),2);
-    beta  = r2/(alpha*pAp);
-    p     = beta*p+r;
-      
-    if((niter%50)==0){
-      std::cout << std::left << std::setw(7) << niter << "\t";
-      std::cout << Norm(r) << std::endl;
-    }
-      
-  }
-    
+
+  std::vector<double> x(b.size(),0.);
+  CGWorkspace ws;
+  SolverControl ctl;
+  ctl.rtol     = 1e-4*Norm(b);
+  ctl.sampling = 50;
+  ctl.monitor  = [](const IterationState& s){
+    std::cout << std::left << std::setw(7) << s.iter << "\t";
+    std::cout << s.residual << std::endl;
+    return true;};
+  cgsolve(A,b,x,ws,ctl);
   return x;
-    
 }
 
 
 
-
 #endif
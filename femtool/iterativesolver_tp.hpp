@@ -7,110 +7,84 @@
 #include <iomanip>
 #include <type_traits>
 #include <vector>
+#include "iterativesolver.hpp"
 
+// Gradient conjugue (preconditionne) arrete lorsque l'erreur en
+// norme d'energie relative a la solution exacte ue passe sous 1e-6
+// (au plus 2000 iterations). L'erreur exacte (A e|e), e = ue-x, est
+// calculee toutes les 10 iterations et ecrite dans filename a la fin;
+// la norme du residu est affichee toutes les 50 iterations. Entre
+// deux mesures, l'arret est detecte sans produit matrice-vecteur par
+// l'estimation |e|^2 ~ |e_k|^2 - (energy - energy_k) (exacte si
+// b = A ue), puis confirme par un calcul exact.
+template <VectorOperator PrecType>
 std::pair<std::vector<double>,int>
-cgsolve_tp(const CooMatrix<double>&   A,
-	const std::vector<double>& b, const std::vector<double>& ue, std::string filename) {
-    
-  assert((NbCol(A)==NbRow(A)) &&
-	 (b.size()==NbCol(A)) );
- 
-  auto    x   = std::vector<double>(b.size(),0.);
-  auto    r   = b-A*x;
-  auto    p   = r;
-  auto   Ap   = A*p;    
-  double r2   = std::pow(Norm(r),2);  
-  double eps2 = (1e-8)*r2;
-  eps2       *= std::abs((b|b));      
-  double alpha,beta,pAp;
-    
-  std::size_t niter = 0;    
-  double errH1 = 1.0;
-  std::ofstream datafile(filename);
+PCGSolver_tp(const CooMatrix<double>&   A,
+	     const std::vector<double>& b,
+	     const PrecType&            Q,
+	     const std::vector<double>& ue,
+	     std::string filename) {
 
-  while (errH1> 1e-6 && niter++<2000){
-   
-      
-    Ap    = A*p;
-    pAp   = std::real((Ap|p));    
-    alpha = r2/pAp;
-    x    += alpha*p;
-    r    -= alpha*Ap;    
-    r2    = std::pow(Norm(r),2);
-    beta  = r2/(alpha*pAp);
-    p     = beta*p+r;
+  assert((NbCol(A)==NbRow(A)) &&
+	 (b.size()==NbCol(A)) && (ue.size()==b.size()) );
 
-    auto err = ue-x;
-    errH1 = std::real((A(err)|err)/(A(ue)|ue));
-    errH1 = std::sqrt(errH1);
-    datafile<<niter<<" ; "<<errH1<<std::endl;
+  constexpr std::size_t period = 10;
+  const double aue  = (A(ue)|ue);
+  const double tol2 = 1e-12*aue;
+  double e2 = aue, energy = 0.;    // derniere mesure exacte
+  std::vector<std::pair<std::size_t,double>> errH1;
+  errH1.reserve(2000/period+2);
 
-    
-      
-    if((niter%50)==0){
-      std::cout << std::left << std::setw(7) << niter << "\t";
-      std::cout << Norm(r) << std::endl;
+  SolverControl ctl;
+  ctl.rtol     = 0.;
+  ctl.maxit    = 2000;
+  ctl.sampling = 1;
+  ctl.monitor  = [&](const IterationState& s){
+    bool sample = (s.iter%period)==0 || e2-(s.energy-energy)<=tol2;
+    if(sample){
+      auto err = ue-s.x;
+      e2     = (A(err)|err);
+      energy = s.energy;
+      errH1.emplace_back(s.iter,std::sqrt(std::abs(e2/aue)));}
+    if((s.iter%50)==0){
+      std::cout << std::left << std::setw(7) << s.iter << "\t";
+      std::cout << Norm(s.r) << std::endl;
     }
-    
-      
-  }
-  datafile.close();
-    
-  return std::make_pair(x,niter);
-    
-}
+    return !(sample && e2<=tol2);
+  };
 
-std::pair<std::vector<double>,int>
-PCGSolver_tp(const CooMatrix<double>&   A,
-	const std::vector<double>& b, const CholeskyPrec& Q, const std::vector<double>& ue, std::string filename) {
-    
-  assert((NbCol(A)==NbRow(A)) &&
-	 (b.size()==NbCol(A)) );
- 
-  auto    x   = std::vector<double>(b.size(),0.);
-  auto    r   = b-A*x;
-  auto z   = Q * r; // Ici on utilise le préconditionneur
-  auto    p   = z;
-  auto   Ap   = A*p; 
-  double rz   = (r|z);  
-  double eps2 = (1e-8)*rz;
-  eps2       *= std::abs((b|b));      
-  double alpha,beta,pAp;
-    
-  
-  std::size_t niter = 0;    
-  double errH1 = 1.0;
-  std::ofstream datafile(filename);  
+  std::vector<double> x(b.size(),0.);
+  CGWorkspace ws;
+  auto rep = PCG(A,b,x,Q,ws,ctl);
 
-  while( errH1>1e-6 && niter++<2000 ){
-      
-    Ap    = A*p;
-    pAp   = std::real((Ap|p));    
-    alpha = rz/pAp;
-    x    += alpha*p;
-    r    -= alpha*Ap;  
-    z     = Q*r;  
-    rz    = (r|z);
-    beta  = rz/(alpha*pAp);
-    p     = beta*p+z;
+  Write(errH1,filename);
 
-    auto err = ue-x;
-    errH1 = std::real((A(err)|err)/(A(ue)|ue));
-    errH1 = std::sqrt(errH1);
-    datafile<<niter<<" ; "<<errH1<<std::endl;
-      
-    if((niter%50)==0){
-      std::cout << std::left << std::setw(7) << niter << "\t";
-      std::cout << Norm(r) << std::endl;
-    }
-      
-  }
-  datafile.close();
-    
-  return std::make_pair(x,niter);
-    
+  return std::make_pair(x,int(rep.niter));
 }
 
+std::pair<std::vector<double>,int>
+cgsolve_tp(const CooMatrix<double>&   A,
+	   const std::vector<double>& b,
+	   const std::vector<double>& ue,
+	   std::string filename) {
+  return PCGSolver_tp(A,b,IdentityPrec(),ue,filename);}
+
+// Noms utilises par les programmes de tp/
+template <VectorOperator PrecType>
+std::pair<std::vector<double>,int>
+PCGSolver(const CooMatrix<double>&   A,
+	  const std::vector<double>& b,
+	  const PrecType&            Q,
+	  const std::vector<double>& ue,
+	  std::string filename) {
+  return PCGSolver_tp(A,b,Q,ue,filename);}
+
+std::pair<std::vector<double>,int>
+cgsolve(const CooMatrix<double>&   A,
+	const std::vector<double>& b,
+	const std::vector<double>& ue,
+	std::string filename) {
+  return cgsolve_tp(A,b,ue,filename);}
 
 
 #endif
@@ -0,0 +1,182 @@
+#ifndef MESHGENERATOR_HPP
+#define MESHGENERATOR_HPP
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <assert.h>
+
+//############################//
+//    Maillages structures    //
+//############################//
+
+Mesh1D Segment(const std::size_t& nx,
+	       const double& lx = 1.){
+
+  assert(nx>0);
+  Nodes v;
+  v.reserve(nx+1);
+  for(std::size_t i=0; i<=nx; ++i){
+    v.push_back(R3{lx*i/nx,0.,0.});}
+
+  Mesh1D m(v);
+  m.reserve(nx);
+  for(std::size_t i=0; i<nx; ++i){
+    m.push_back(v[i],v[i+1]);}
+  return m;
+}
+
+Mesh2D Rectangle(const std::size_t& nx,
+		 const std::size_t& ny,
+		 const double& lx = 1.,
+		 const double& ly = 1.){
+
+  assert(nx>0 && ny>0);
+  Nodes v;
+  v.reserve((nx+1)*(ny+1));
+  for(std::size_t j=0; j<=ny; ++j){
+    for(std::size_t i=0; i<=nx; ++i){
+      v.push_back(R3{lx*i/nx,ly*j/ny,0.});}}
+
+  auto I = [&](const std::size_t& i, const std::size_t& j){
+    return i+(nx+1)*j;};
+
+  // Chaque carre est coupe selon la diagonale (0,0)-(1,1)
+  Mesh2D m(v);
+  m.reserve(2*nx*ny);
+  for(std::size_t j=0; j<ny; ++j){
+    for(std::size_t i=0; i<nx; ++i){
+      m.push_back(v[I(i,j)],v[I(i+1,j)],v[I(i+1,j+1)]);
+      m.push_back(v[I(i,j)],v[I(i,j+1)],v[I(i+1,j+1)]);
+    }
+  }
+  return m;
+}
+
+Mesh3D Box(const std::size_t& nx,
+	   const std::size_t& ny,
+	   const std::size_t& nz,
+	   const double& lx = 1.,
+	   const double& ly = 1.,
+	   const double& lz = 1.){
+
+  assert(nx>0 && ny>0 && nz>0);
+  Nodes v;
+  v.reserve((nx+1)*(ny+1)*(nz+1));
+  for(std::size_t k=0; k<=nz; ++k){
+    for(std::size_t j=0; j<=ny; ++j){
+      for(std::size_t i=0; i<=nx; ++i){
+	v.push_back(R3{lx*i/nx,ly*j/ny,lz*k/nz});}}}
+
+  auto I = [&](const std::size_t& i, const std::size_t& j,
+	       const std::size_t& k){
+    return i+(nx+1)*(j+(ny+1)*k);};
+
+  // Decoupage de Kuhn: 6 tetraedres autour de la diagonale (0,0,0)-(1,1,1)
+  const std::array<std::array<std::size_t,3>,6> axes =
+    {{ {0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0} }};
+
+  Mesh3D m(v);
+  m.reserve(6*nx*ny*nz);
+  for(std::size_t k=0; k<nz; ++k){
+    for(std::size_t j=0; j<ny; ++j){
+      for(std::size_t i=0; i<nx; ++i){
+	for(const auto& a:axes){
+	  std::array<std::size_t,3> c = {i,j,k};
+	  std::size_t p0 = I(c[0],c[1],c[2]); ++c[a[0]];
+	  std::size_t p1 = I(c[0],c[1],c[2]); ++c[a[1]];
+	  std::size_t p2 = I(c[0],c[1],c[2]); ++c[a[2]];
+	  std::size_t p3 = I(c[0],c[1],c[2]);
+	  m.push_back(v[p0],v[p1],v[p2],v[p3]);
+	}
+      }
+    }
+  }
+  return m;
+}
+
+
+//############################//
+//     Raffinement uniforme   //
+//############################//
+
+template <std::size_t DIM>
+auto Refine(const Mesh<DIM>& m){
+
+  static_assert(DIM>=1 && DIM<=3);
+  constexpr std::size_t d  = DIM+1;
+  constexpr std::size_t ne = (DIM*(DIM+1))/2;
+  constexpr std::size_t nc = std::size_t(1)<<DIM;
+
+  const auto v = m.nodes();
+
+  // Numerotation globale des aretes
+  using NxNxN = std::tuple<std::size_t,std::size_t,std::size_t>;
+  std::vector<NxNxN> tbl;
+  tbl.reserve(ne*m.size());
+  for(std::size_t j=0; j<m.size(); ++j){
+    std::size_t l = 0;
+    for(std::size_t p=0; p<d; ++p){
+      for(std::size_t q=p+1; q<d; ++q){
+	tbl.push_back({v.index(m[j][p]),v.index(m[j][q]),l+j*ne});
+	++l;}}
+  }
+  std::sort(tbl.begin(),tbl.end());
+
+  std::vector<std::size_t> edge(ne*m.size());
+  std::vector<std::array<std::size_t,2>> ends;
+  ends.reserve(tbl.size()/2+1);
+  for(std::size_t j=0; j<tbl.size(); ++j){
+    const auto& [a,b,jl] = tbl[j];
+    if(j==0 || a!=std::get<0>(tbl[j-1]) || b!=std::get<1>(tbl[j-1])){
+      ends.push_back({a,b});}
+    edge[jl] = ends.size()-1;
+  }
+
+  // Noeuds: anciens sommets puis milieux d'aretes
+  Nodes new_v;
+  new_v.reserve(v.size()+ends.size());
+  for(const auto& x:v){new_v.push_back(x);}
+  for(const auto& [a,b]:ends){
+    new_v.push_back(0.5*(v[a]+v[b]));}
+
+  // Sous-elements exprimes avec les indices locaux
+  // 0..DIM (sommets) puis d+l (milieu de la l-ieme arete)
+  std::vector<std::array<std::size_t,d>> child;
+  if constexpr(DIM==1){
+    child = {{0,2},{2,1}};}
+  if constexpr(DIM==2){
+    // aretes: 01->3, 02->4, 12->5
+    child = {{0,3,4},{3,1,5},{4,5,2},{3,4,5}};}
+  if constexpr(DIM==3){
+    // aretes: 01->4, 02->5, 03->6, 12->7, 13->8, 23->9
+    // octaedre central coupe selon la diagonale 02-13 (Bey)
+    child = {{0,4,5,6},{4,1,7,8},{5,7,2,9},{6,8,9,3},
+	     {4,5,6,8},{4,5,7,8},{5,6,8,9},{5,7,8,9}};}
+
+  Mesh<DIM> new_m(new_v);
+  new_m.reserve(nc*m.size());
+  std::vector<std::size_t> parent;
+  parent.reserve(nc*m.size());
+  std::array<std::size_t,d+ne> I;
+  Element<DIM> e;
+  for(std::size_t j=0; j<m.size(); ++j){
+    for(std::size_t p=0; p<d; ++p){
+      I[p] = v.index(m[j][p]);}
+    for(std::size_t l=0; l<ne; ++l){
+      I[d+l] = v.size()+edge[l+j*ne];}
+
+    for(const auto& c:child){
+      for(const auto& p:c){e.push_back(new_v[I[p]]);}
+      new_m.push_back(e);
+      parent.push_back(j);
+      e.clear();
+    }
+  }
+
+  return std::make_tuple(new_m,parent);
+}
+
+
+#endif
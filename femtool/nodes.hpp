@@ -58,6 +58,10 @@ public:
   const auto& operator[](const std::size_t& j) const {
     return (*data_ptr)[j];}
 
+  std::size_t index(const R3& x) const {
+    assert(&x>=data_ptr->data() && &x<data_ptr->data()+size());
+    return std::size_t(&x-data_ptr->data());}
+
   friend bool operator==(const Nodes& v1, const Nodes& v2){
     return v1.data_ptr==v2.data_ptr;}
   
@@ -0,0 +1,493 @@
+#ifndef ORDERING_HPP
+#define ORDERING_HPP
+
+#include <vector>
+#include <limits>
+#include <numeric>
+#include <functional>
+#include <algorithm>
+#include <assert.h>
+#include <Eigen/Sparse>
+#include <Eigen/OrderingMethods>
+#include "coomatrix.hpp"
+
+// Les renumerotations renvoyees suivent la convention de
+// renumbering.hpp: perm[nouveau] = ancien.
+
+//############################//
+//  Graphe d'adjacence (CSR)  //
+//############################//
+
+class Graph{
+
+public:
+
+  Graph(const std::size_t& n = 0): offset(n+1,0) {};
+
+  std::size_t size() const {return offset.size()-1;}
+
+  std::size_t degree(const std::size_t& j) const {
+    return offset[j+1]-offset[j];}
+
+  const std::size_t* begin(const std::size_t& j) const {
+    return adj.data()+offset[j];}
+
+  const std::size_t* end(const std::size_t& j) const {
+    return adj.data()+offset[j+1];}
+
+  // Voisins de j (sans j lui-meme)
+  std::vector<std::size_t> offset;
+  std::vector<std::size_t> adj;
+
+};
+
+
+// Graphe symetrise du profil d'une matrice, diagonale exclue
+template <typename ValueType>
+Graph Adjacency(const CooMatrix<ValueType>& A){
+
+  assert(NbRow(A)==NbCol(A));
+  std::size_t n = NbRow(A);
+  Graph g(n);
+
+  for(const auto& [j,k,v]:A){
+    if(j!=k){++g.offset[j+1]; ++g.offset[k+1];}}
+  std::partial_sum(g.offset.begin(),g.offset.end(),g.offset.begin());
+
+  std::vector<std::size_t> adj(g.offset[n]);
+  std::vector<std::size_t> pos(g.offset.begin(),g.offset.end()-1);
+  for(const auto& [j,k,v]:A){
+    if(j!=k){adj[pos[j]++] = k; adj[pos[k]++] = j;}}
+
+  // Suppression des doublons
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> mark(n,npos);
+  g.adj.reserve(adj.size());
+  std::size_t p = 0;
+  for(std::size_t j=0; j<n; ++j){
+    for(; p<g.offset[j+1]; ++p){
+      if(mark[adj[p]]!=j){
+	mark[adj[p]] = j;
+	g.adj.push_back(adj[p]);}
+    }
+    g.offset[j+1] = g.adj.size();
+  }
+  return g;
+}
+
+// Graphe des ddl: deux ddl sont voisins s'ils partagent une cellule
+template <std::size_t DIM>
+Graph Adjacency(const FeSpace<DIM>& Vh){
+
+  std::size_t n = dim(Vh);
+  std::size_t d = local_dim(Vh);
+
+  // Incidence ddl -> cellules
+  std::vector<std::size_t> cnt(n+1,0);
+  for(const auto& I:Vh){
+    for(const auto& Ik:I){++cnt[Ik+1];}}
+  std::partial_sum(cnt.begin(),cnt.end(),cnt.begin());
+  std::vector<std::size_t> cell(cnt[n]);
+  std::vector<std::size_t> pos(cnt.begin(),cnt.end()-1);
+  for(std::size_t j=0; j<Vh.size(); ++j){
+    for(const auto& Ik:Vh[j]){cell[pos[Ik]++] = j;}}
+
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> mark(n,npos);
+  Graph g(n);
+  g.adj.reserve(cnt[n]*(d-1));
+  for(std::size_t j=0; j<n; ++j){
+    mark[j] = j;
+    for(std::size_t p=cnt[j]; p<cnt[j+1]; ++p){
+      for(const auto& Ik:Vh[cell[p]]){
+	if(mark[Ik]!=j){
+	  mark[Ik] = j;
+	  g.adj.push_back(Ik);}
+      }
+    }
+    g.offset[j+1] = g.adj.size();
+  }
+  return g;
+}
+
+
+//############################//
+//   Parcours en largeur      //
+//############################//
+
+// Parcours restreint aux sommets j tels que where[j]==lbl.
+// Renvoie les sommets visites niveau par niveau, le niveau l
+// occupant visit[bound[l]] ... visit[bound[l+1]-1].
+auto LevelStructure(const Graph& g,
+		    const std::size_t& root,
+		    const std::vector<std::size_t>& where,
+		    const std::size_t& lbl,
+		    std::vector<std::size_t>& level){
+
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> visit = {root};
+  std::vector<std::size_t> bound = {0,1};
+  level[root] = 0;
+  while(bound.back()>bound[bound.size()-2]){
+    for(std::size_t p=bound[bound.size()-2]; p<bound.back(); ++p){
+      std::size_t j = visit[p];
+      for(auto q=g.begin(j); q!=g.end(j); ++q){
+	if(where[*q]==lbl && level[*q]==npos){
+	  level[*q] = level[j]+1;
+	  visit.push_back(*q);}
+      }
+    }
+    bound.push_back(visit.size());
+  }
+  bound.pop_back();
+  for(const auto& j:visit){level[j] = npos;}
+  return std::make_pair(visit,bound);
+}
+
+// Sommet pseudo-peripherique (George-Liu)
+std::size_t PseudoPeripheral(const Graph& g,
+			     std::size_t root,
+			     const std::vector<std::size_t>& where,
+			     const std::size_t& lbl,
+			     std::vector<std::size_t>& level){
+
+  auto [visit,bound] = LevelStructure(g,root,where,lbl,level);
+  std::size_t ecc = bound.size();
+  while(true){
+    std::size_t next = visit[bound[bound.size()-2]];
+    for(std::size_t p=bound[bound.size()-2]; p<visit.size(); ++p){
+      if(g.degree(visit[p])<g.degree(next)){next = visit[p];}}
+    auto [visit2,bound2] = LevelStructure(g,next,where,lbl,level);
+    if(bound2.size()<=ecc){break;}
+    root  = next;
+    ecc   = bound2.size();
+    visit = std::move(visit2);
+    bound = std::move(bound2);
+  }
+  return root;
+}
+
+
+//############################//
+//  Reverse Cuthill-McKee     //
+//############################//
+
+std::vector<std::size_t>
+RcmOrdering(const Graph& g){
+
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  std::size_t n = g.size();
+  std::vector<std::size_t> where(n,0);
+  std::vector<std::size_t> level(n,npos);
+  std::vector<char> done(n,0);
+
+  // Sommets par degre croissant (choix des racines)
+  std::vector<std::size_t> seed(n);
+  std::iota(seed.begin(),seed.end(),0);
+  std::stable_sort(seed.begin(),seed.end(),
+		   [&g](const std::size_t& a, const std::size_t& b){
+		     return g.degree(a)<g.degree(b);});
+
+  std::vector<std::size_t> perm;
+  perm.reserve(n);
+  std::vector<std::size_t> nbr;
+  for(const auto& s:seed){
+    if(done[s]){continue;}
+
+    // Composante connexe courante
+    std::size_t root = PseudoPeripheral(g,s,where,0,level);
+    std::size_t p = perm.size();
+    perm.push_back(root);
+    done[root] = 1;
+    for(; p<perm.size(); ++p){
+      nbr.clear();
+      for(auto q=g.begin(perm[p]); q!=g.end(perm[p]); ++q){
+	if(!done[*q]){done[*q] = 1; nbr.push_back(*q);}}
+      std::stable_sort(nbr.begin(),nbr.end(),
+		       [&g](const std::size_t& a, const std::size_t& b){
+			 return g.degree(a)<g.degree(b);});
+      perm.insert(perm.end(),nbr.begin(),nbr.end());
+    }
+  }
+
+  std::reverse(perm.begin(),perm.end());
+  return perm;
+}
+
+
+//############################//
+//  Degre minimum approche    //
+//############################//
+
+std::vector<std::size_t>
+AmdOrdering(const Graph& g){
+
+  std::size_t n = g.size();
+  using NxNxT = Eigen::Triplet<double>;
+  std::vector<NxNxT> jkv;
+  jkv.reserve(g.adj.size()+n);
+  for(std::size_t j=0; j<n; ++j){
+    jkv.push_back(NxNxT(int(j),int(j),1.));
+    for(auto q=g.begin(j); q!=g.end(j); ++q){
+      jkv.push_back(NxNxT(int(j),int(*q),1.));}
+  }
+  Eigen::SparseMatrix<double> Ae(n,n);
+  Ae.setFromTriplets(jkv.begin(),jkv.end());
+
+  Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,int> P;
+  Eigen::AMDOrdering<int> amd;
+  amd(Ae,P);
+
+  // Eigen renvoie l'ordre d'elimination: P.indices()[nouveau] = ancien
+  std::vector<std::size_t> perm(n);
+  for(std::size_t j=0; j<n; ++j){
+    perm[j] = std::size_t(P.indices()[j]);}
+  return perm;
+}
+
+
+//############################//
+//   Dissection emboitee      //
+//############################//
+
+// Decoupe de set en deux parties A et B et un separateur S, de sorte
+// qu'aucune arete ne relie A a B (set est connexe). Renvoie false si
+// la decoupe echoue.
+using SplitterType = std::function<bool(const std::vector<std::size_t>& set,
+					const std::vector<std::size_t>& where,
+					const std::size_t& lbl,
+					std::vector<std::size_t>& A,
+					std::vector<std::size_t>& B,
+					std::vector<std::size_t>& S)>;
+
+// Composantes connexes du sous-graphe des sommets de set (tous de
+// label lbl), en un seul parcours; seen sert de marqueur (valeur
+// stamp pour les sommets visites).
+std::vector<std::vector<std::size_t>>
+Components(const Graph& g,
+	   const std::vector<std::size_t>& set,
+	   const std::vector<std::size_t>& where,
+	   const std::size_t& lbl,
+	   std::vector<std::size_t>& seen,
+	   const std::size_t& stamp){
+
+  std::vector<std::vector<std::size_t>> comp;
+  for(const auto& s:set){
+    if(seen[s]==stamp){continue;}
+    seen[s] = stamp;
+    std::vector<std::size_t> c = {s};
+    for(std::size_t p=0; p<c.size(); ++p){
+      for(auto q=g.begin(c[p]); q!=g.end(c[p]); ++q){
+	if(where[*q]==lbl && seen[*q]!=stamp){
+	  seen[*q] = stamp;
+	  c.push_back(*q);}
+      }
+    }
+    comp.push_back(std::move(c));
+  }
+  return comp;
+}
+
+// Les ensembles a traiter sont empiles (pas de recursion): chaque
+// ensemble est d'abord decompose en composantes connexes, ordonnees
+// l'une apres l'autre; un ensemble connexe est decoupe en A, B, S
+// et renumerote dans l'ordre A, B, S.
+std::vector<std::size_t>
+NestedDissection(const Graph& g,
+		 const SplitterType& split,
+		 const std::size_t& leaf = 64){
+
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  std::size_t n = g.size();
+  std::vector<std::size_t> where(n,0), seen(n,npos);
+  std::vector<std::size_t> perm;
+  perm.reserve(n);
+  std::size_t nlbl = 1, stamp = 0;
+
+  struct Task{
+    std::vector<std::size_t> set;
+    std::size_t              lbl;
+    bool                     sep;   // separateur: numerote tel quel
+  };
+  std::vector<Task> stack;
+  std::vector<std::size_t> all(n);
+  std::iota(all.begin(),all.end(),0);
+  stack.push_back({std::move(all),0,false});
+
+  while(!stack.empty()){
+    Task t = std::move(stack.back());
+    stack.pop_back();
+    if(t.sep || t.set.size()<=leaf){
+      perm.insert(perm.end(),t.set.begin(),t.set.end());
+      continue;}
+
+    auto comp = Components(g,t.set,where,t.lbl,seen,stamp++);
+    if(comp.size()>1){
+      t.set.clear(); t.set.shrink_to_fit();
+      for(auto c=comp.rbegin(); c!=comp.rend(); ++c){
+	std::size_t lc = nlbl++;
+	for(const auto& j:*c){where[j] = lc;}
+	stack.push_back({std::move(*c),lc,false});
+      }
+      continue;
+    }
+
+    std::vector<std::size_t> A,B,S;
+    if(!split(t.set,where,t.lbl,A,B,S)){
+      perm.insert(perm.end(),t.set.begin(),t.set.end());
+      continue;}
+    t.set.clear(); t.set.shrink_to_fit();
+
+    std::size_t la = nlbl++, lb = nlbl++;
+    for(const auto& j:A){where[j] = la;}
+    for(const auto& j:B){where[j] = lb;}
+    for(const auto& j:S){where[j] = npos;}
+    stack.push_back({std::move(S),npos,true});
+    stack.push_back({std::move(B),lb,false});
+    stack.push_back({std::move(A),la,false});
+  }
+
+  return perm;
+}
+
+// Separateur: niveau median d'une structure en niveaux
+std::vector<std::size_t>
+NestedDissectionOrdering(const Graph& g,
+			 const std::size_t& leaf = 64){
+
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> level(g.size(),npos);
+
+  auto split = [&](const std::vector<std::size_t>& set,
+		   const std::vector<std::size_t>& where,
+		   const std::size_t& lbl,
+		   std::vector<std::size_t>& A,
+		   std::vector<std::size_t>& B,
+		   std::vector<std::size_t>& S){
+
+    std::size_t root = PseudoPeripheral(g,set[0],where,lbl,level);
+    auto [visit,bound] = LevelStructure(g,root,where,lbl,level);
+
+    // Ensemble connexe (voir NestedDissection)
+    assert(visit.size()==set.size());
+
+    std::size_t nl = bound.size()-1;
+    if(nl<3){return false;}
+    std::size_t m = 1;
+    while(m<nl-2 && bound[m+1]<visit.size()/2){++m;}
+
+    A.assign(visit.begin(),visit.begin()+bound[m]);
+    S.assign(visit.begin()+bound[m],visit.begin()+bound[m+1]);
+    B.assign(visit.begin()+bound[m+1],visit.end());
+    return true;
+  };
+
+  return NestedDissection(g,split,leaf);
+}
+
+// Separateur geometrique: plan median selon la plus grande
+// dimension de la boite englobante des sommets
+std::vector<std::size_t>
+NestedDissectionOrdering(const Graph& g,
+			 const std::vector<R3>& x,
+			 const std::size_t& leaf = 64){
+
+  assert(x.size()==g.size());
+  std::vector<char> side(g.size(),0);
+
+  auto split = [&](const std::vector<std::size_t>& set,
+		   const std::vector<std::size_t>& where,
+		   const std::size_t& lbl,
+		   std::vector<std::size_t>& A,
+		   std::vector<std::size_t>& B,
+		   std::vector<std::size_t>& S){
+
+    R3 xmin = x[set[0]], xmax = x[set[0]];
+    for(const auto& j:set){
+      for(std::size_t k=0; k<3; ++k){
+	xmin[k] = std::min(xmin[k],x[j][k]);
+	xmax[k] = std::max(xmax[k],x[j][k]);}}
+    std::size_t ax = 0;
+    for(std::size_t k=1; k<3; ++k){
+      if(xmax[k]-xmin[k]>xmax[ax]-xmin[ax]){ax = k;}}
+
+    std::vector<std::size_t> tmp = set;
+    auto mid = tmp.begin()+tmp.size()/2;
+    std::nth_element(tmp.begin(),mid,tmp.end(),
+		     [&](const std::size_t& a, const std::size_t& b){
+		       return x[a][ax]<x[b][ax];});
+    for(auto it=tmp.begin(); it!=tmp.end(); ++it){
+      side[*it] = (it<mid ? 1 : 2);}
+
+    // Les sommets de B voisins de A forment le separateur
+    for(const auto& j:set){
+      if(side[j]==1){A.push_back(j); continue;}
+      bool sep = false;
+      for(auto q=g.begin(j); q!=g.end(j) && !sep; ++q){
+	sep = (where[*q]==lbl && side[*q]==1);}
+      if(sep){S.push_back(j);}
+      else   {B.push_back(j);}
+    }
+    for(const auto& j:set){side[j] = 0;}
+    return !A.empty() && !B.empty();
+  };
+
+  return NestedDissection(g,split,leaf);
+}
+
+
+//############################//
+// Choix de la renumerotation //
+//############################//
+
+enum class OrderingType { Natural, RCM, AMD,
+			  NestedDissection,
+			  GeometricNestedDissection };
+
+// Sans coordonnees, la dissection geometrique est remplacee
+// par la dissection sur le graphe
+std::vector<std::size_t>
+Ordering(const Graph& g,
+	 const OrderingType& type){
+
+  switch(type){
+  case OrderingType::RCM:              return RcmOrdering(g);
+  case OrderingType::AMD:              return AmdOrdering(g);
+  case OrderingType::NestedDissection:
+  case OrderingType::GeometricNestedDissection:
+    return NestedDissectionOrdering(g);
+  case OrderingType::Natural:          break;
+  }
+  std::vector<std::size_t> perm(g.size());
+  std::iota(perm.begin(),perm.end(),0);
+  return perm;
+}
+
+template <std::size_t DIM>
+std::vector<std::size_t>
+Ordering(const FeSpace<DIM>& Vh,
+	 const OrderingType& type = OrderingType::NestedDissection){
+  auto g = Adjacency(Vh);
+  if(type==OrderingType::GeometricNestedDissection){
+    return NestedDissectionOrdering(g,Points(Vh));}
+  return Ordering(g,type);
+}
+
+template <typename ValueType>
+std::vector<std::size_t>
+Ordering(const CooMatrix<ValueType>& A,
+	 const OrderingType& type = OrderingType::AMD){
+  return Ordering(Adjacency(A),type);
+}
+
+// Largeur de bande d'une matrice
+template <typename ValueType>
+std::size_t Bandwidth(const CooMatrix<ValueType>& A){
+  std::size_t bw = 0;
+  for(const auto& [j,k,v]:A){
+    bw = std::max(bw, (j>k ? j-k : k-j));}
+  return bw;
+}
+
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef P1KERNEL_HPP
+#define P1KERNEL_HPP
+
+#include <array>
+#include <cmath>
+#include <assert.h>
+
+//############################//
+//  Noyaux P1 par lots (SoA)  //
+//############################//
+
+// Les matrices elementaires sont calculees pour P1Lanes elements a
+// la fois: chaque grandeur est stockee sous forme d'un tableau de
+// P1Lanes valeurs (une par element), et toutes les boucles portent
+// sur ces tableaux, ce qui permet au compilateur de vectoriser.
+//
+// Avec a_i = x_i - x_0 (i=1..DIM), J = [a_1 ... a_DIM] et g = J^T J,
+// les gradients des fonctions de forme verifient
+//   K_ij = |e| (D_i . g^{-1} D_j),  D_0 = -(1,...,1), D_i = e_i,
+// ce qui evite normales, normalisations et racines carrees
+// (une seule racine en dimension 1 et 2, aucune en dimension 3).
+
+constexpr std::size_t P1Lanes = 8;
+
+template <std::size_t W>
+using Lanes = std::array<double,W>;
+
+template <std::size_t DIM, std::size_t W = P1Lanes>
+using P1Coords = std::array<std::array<Lanes<W>,3>,DIM+1>;
+
+template <std::size_t DIM, std::size_t W = P1Lanes>
+using P1Grad = std::array<std::array<Lanes<W>,3>,DIM+1>;
+
+template <std::size_t DIM, std::size_t W = P1Lanes>
+using P1Matrix = std::array<Lanes<W>,(DIM+1)*(DIM+1)>;
+
+
+// Chargement des sommets des elements elts[0..n), n<=W.
+// Les lanes inutilisees reprennent le dernier element.
+template <std::size_t DIM, std::size_t W>
+void P1Load(const FeSpace<DIM>& Vh,
+	    const std::size_t* elts,
+	    const std::size_t& n,
+	    P1Coords<DIM,W>& x){
+  assert(n>0 && n<=W);
+  for(std::size_t w=0; w<W; ++w){
+    const auto& e = Vh[elts[std::min(w,n-1)]].elt();
+    for(std::size_t k=0; k<DIM+1; ++k){
+      for(std::size_t c=0; c<3; ++c){
+	x[k][c][w] = e[k][c];}}
+  }
+}
+
+template <std::size_t DIM, std::size_t W>
+void P1Load(const Mesh<DIM>& m,
+	    const std::size_t* elts,
+	    const std::size_t& n,
+	    P1Coords<DIM,W>& x){
+  assert(n>0 && n<=W);
+  for(std::size_t w=0; w<W; ++w){
+    const auto& e = m[elts[std::min(w,n-1)]];
+    for(std::size_t k=0; k<DIM+1; ++k){
+      for(std::size_t c=0; c<3; ++c){
+	x[k][c][w] = e[k][c];}}
+  }
+}
+
+// Aretes a_i = x_i - x_0
+template <std::size_t DIM, std::size_t W>
+auto P1Edges(const P1Coords<DIM,W>& x){
+  std::array<std::array<Lanes<W>,3>,DIM> a;
+  for(std::size_t i=0; i<DIM; ++i){
+    for(std::size_t c=0; c<3; ++c){
+      for(std::size_t w=0; w<W; ++w){
+	a[i][c][w] = x[i+1][c][w]-x[0][c][w];}}}
+  return a;
+}
+
+template <std::size_t W>
+auto P1Dot(const std::array<Lanes<W>,3>& u,
+	   const std::array<Lanes<W>,3>& v){
+  Lanes<W> p;
+  for(std::size_t w=0; w<W; ++w){
+    p[w] = u[0][w]*v[0][w]+u[1][w]*v[1][w]+u[2][w]*v[2][w];}
+  return p;
+}
+
+template <std::size_t W>
+auto P1Cross(const std::array<Lanes<W>,3>& u,
+	     const std::array<Lanes<W>,3>& v){
+  std::array<Lanes<W>,3> p;
+  for(std::size_t w=0; w<W; ++w){
+    p[0][w] = u[1][w]*v[2][w]-u[2][w]*v[1][w];
+    p[1][w] = u[2][w]*v[0][w]-u[0][w]*v[2][w];
+    p[2][w] = u[0][w]*v[1][w]-u[1][w]*v[0][w];}
+  return p;
+}
+
+// Mesure des elements et matrice g^{-1} mise a l'echelle:
+// ginv[i][j] = |e| (g^{-1})_ij
+template <std::size_t DIM, std::size_t W>
+void P1Metric(const P1Coords<DIM,W>& x,
+	      Lanes<W>& vol,
+	      std::array<std::array<Lanes<W>,DIM>,DIM>& ginv){
+
+  auto a = P1Edges<DIM,W>(x);
+
+  if constexpr(DIM==1){
+    auto g = P1Dot<W>(a[0],a[0]);
+    for(std::size_t w=0; w<W; ++w){
+      vol[w] = std::sqrt(g[w]);
+      ginv[0][0][w] = 1./vol[w];}
+  }
+
+  if constexpr(DIM==2){
+    auto g00 = P1Dot<W>(a[0],a[0]);
+    auto g01 = P1Dot<W>(a[0],a[1]);
+    auto g11 = P1Dot<W>(a[1],a[1]);
+    for(std::size_t w=0; w<W; ++w){
+      double det = g00[w]*g11[w]-g01[w]*g01[w];
+      double sq  = std::sqrt(det);
+      double s   = 0.5/sq;
+      vol[w] = 0.5*sq;
+      ginv[0][0][w] =  s*g11[w];
+      ginv[0][1][w] = -s*g01[w];
+      ginv[1][0][w] = -s*g01[w];
+      ginv[1][1][w] =  s*g00[w];}
+  }
+
+  if constexpr(DIM==3){
+    // Lignes de J^{-1}: (a1 x a2, a2 x a0, a0 x a1)/det J
+    std::array<std::array<Lanes<W>,3>,3> C =
+      {P1Cross<W>(a[1],a[2]),P1Cross<W>(a[2],a[0]),P1Cross<W>(a[0],a[1])};
+    auto det = P1Dot<W>(a[0],C[0]);
+    Lanes<W> s;
+    for(std::size_t w=0; w<W; ++w){
+      vol[w] = std::abs(det[w])/6.;
+      s[w]   = 1./(6.*std::abs(det[w]));}
+    for(std::size_t i=0; i<3; ++i){
+      for(std::size_t j=i; j<3; ++j){
+	auto cij = P1Dot<W>(C[i],C[j]);
+	for(std::size_t w=0; w<W; ++w){
+	  ginv[i][j][w] = s[w]*cij[w];
+	  ginv[j][i][w] = ginv[i][j][w];}
+      }
+    }
+  }
+}
+
+template <std::size_t DIM, std::size_t W>
+void P1Volume(const P1Coords<DIM,W>& x,
+	      Lanes<W>& vol){
+
+  auto a = P1Edges<DIM,W>(x);
+  if constexpr(DIM==1){
+    auto g = P1Dot<W>(a[0],a[0]);
+    for(std::size_t w=0; w<W; ++w){vol[w] = std::sqrt(g[w]);}}
+  if constexpr(DIM==2){
+    auto c = P1Cross<W>(a[0],a[1]);
+    auto n = P1Dot<W>(c,c);
+    for(std::size_t w=0; w<W; ++w){vol[w] = 0.5*std::sqrt(n[w]);}}
+  if constexpr(DIM==3){
+    auto det = P1Dot<W>(a[0],P1Cross<W>(a[1],a[2]));
+    for(std::size_t w=0; w<W; ++w){vol[w] = std::abs(det[w])/6.;}}
+}
+
+// Matrice de rigidite elementaire K[j*(DIM+1)+k][w]
+template <std::size_t DIM, std::size_t W>
+void P1Stiffness(const P1Coords<DIM,W>& x,
+		 Lanes<W>& vol,
+		 P1Matrix<DIM,W>& K){
+
+  constexpr std::size_t d = DIM+1;
+  std::array<std::array<Lanes<W>,DIM>,DIM> ginv;
+  P1Metric<DIM,W>(x,vol,ginv);
+
+  // Sommes partielles pour le sommet 0 (D_0 = -(1,...,1))
+  std::array<Lanes<W>,DIM> r;
+  Lanes<W> t;
+  t.fill(0.);
+  for(std::size_t i=0; i<DIM; ++i){
+    r[i].fill(0.);
+    for(std::size_t j=0; j<DIM; ++j){
+      for(std::size_t w=0; w<W; ++w){
+	r[i][w] += ginv[i][j][w];}}
+    for(std::size_t w=0; w<W; ++w){t[w] += r[i][w];}
+  }
+
+  K[0] = t;
+  for(std::size_t i=0; i<DIM; ++i){
+    for(std::size_t w=0; w<W; ++w){
+      K[(i+1)][w]   = -r[i][w];
+      K[(i+1)*d][w] = -r[i][w];}
+    for(std::size_t j=0; j<DIM; ++j){
+      K[(i+1)*d+(j+1)] = ginv[i][j];}
+  }
+}
+
+// Gradients des fonctions de forme: G_i = J g^{-1} D_i
+template <std::size_t DIM, std::size_t W>
+void P1Gradients(const P1Coords<DIM,W>& x,
+		 Lanes<W>& vol,
+		 P1Grad<DIM,W>& G){
+
+  std::array<std::array<Lanes<W>,DIM>,DIM> ginv;
+  P1Metric<DIM,W>(x,vol,ginv);
+  auto a = P1Edges<DIM,W>(x);
+
+  for(std::size_t c=0; c<3; ++c){
+    G[0][c].fill(0.);
+    for(std::size_t i=0; i<DIM; ++i){
+      for(std::size_t w=0; w<W; ++w){
+	double g = 0.;
+	for(std::size_t j=0; j<DIM; ++j){g += a[j][c][w]*ginv[j][i][w];}
+	G[i+1][c][w] = g/vol[w];
+	G[0][c][w]  -= G[i+1][c][w];}
+    }
+  }
+}
+
+// Matrice de rigidite a partir des gradients deja calcules
+template <std::size_t DIM, std::size_t W>
+void P1Stiffness(const Lanes<W>& vol,
+		 const P1Grad<DIM,W>& G,
+		 P1Matrix<DIM,W>& K){
+  constexpr std::size_t d = DIM+1;
+  for(std::size_t j=0; j<d; ++j){
+    for(std::size_t k=j; k<d; ++k){
+      auto gg = P1Dot<W>(G[j],G[k]);
+      for(std::size_t w=0; w<W; ++w){
+	K[j*d+k][w] = vol[w]*gg[w];}
+      K[k*d+j] = K[j*d+k];}}
+}
+
+// Matrice de masse elementaire
+template <std::size_t DIM, std::size_t W>
+void P1Mass(const Lanes<W>& vol,
+	    P1Matrix<DIM,W>& M){
+  constexpr std::size_t d = DIM+1;
+  for(std::size_t j=0; j<d; ++j){
+    for(std::size_t k=0; k<d; ++k){
+      double c = (j==k ? 2. : 1.)/((DIM+1.)*(DIM+2.));
+      for(std::size_t w=0; w<W; ++w){
+	M[j*d+k][w] = c*vol[w];}}}
+}
+
+// Rangement element par element des n premieres lanes
+template <std::size_t DIM, std::size_t W>
+void P1Store(const P1Matrix<DIM,W>& K,
+	     const std::size_t& n,
+	     std::array<double,(DIM+1)*(DIM+1)>* Ae){
+  for(std::size_t l=0; l<n; ++l){
+    for(std::size_t pq=0; pq<(DIM+1)*(DIM+1); ++pq){
+      Ae[l][pq] = K[pq][l];}}
+}
+
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+//############################//
+//  Nombre de threads utilise //
+//############################//
+
+std::size_t& NbThread(){
+  static std::size_t nt =
+    std::max<std::size_t>(1,std::thread::hardware_concurrency());
+  return nt;}
+
+
+// Marqueur des surcharges qui evaluent une fonction de l'utilisateur
+// depuis plusieurs threads: elle doit alors etre reentrante.
+struct ParallelTag{};
+constexpr ParallelTag Parallel{};
+
+
+//############################//
+//  Reserve de threads        //
+//############################//
+
+// Threads de travail crees a la demande puis conserves: une region
+// parallele ne cree plus de threads (ni n'alloue) une fois la reserve
+// a la taille NbThread(). run(nt,fct) appelle fct(t), t dans [0,nt),
+// t = 0 etant execute par l'appelant. Les regions sont executees une
+// a la fois; un appel depuis l'interieur d'une region (Active())
+// doit etre traite sequentiellement par l'appelant. Si des taches
+// levent une exception, run attend la fin de toutes les taches puis
+// relance celle de l'appelant, ou a defaut la premiere des workers.
+class ThreadPool{
+
+public:
+
+  static ThreadPool& Get(){
+    static ThreadPool pool;
+    return pool;}
+
+  static bool& Active(){
+    thread_local bool active = false;
+    return active;}
+
+  template <typename FctType>
+  void run(const std::size_t& nt, FctType& fct){
+    std::lock_guard<std::mutex> region(busy);
+    {
+      std::lock_guard<std::mutex> lock(m);
+      while(workers.size()+1<nt){
+	std::size_t id = workers.size()+1;
+	workers.emplace_back([this,id](){loop(id);});}
+      call  = [](void* c, const std::size_t& t){
+	(*static_cast<FctType*>(c))(t);};
+      ctx     = &fct;
+      ntask   = nt;
+      pending = nt-1;
+      ++generation;
+    }
+    wake.notify_all();
+
+    // Attente des workers, meme si fct(0) leve une exception
+    std::exception_ptr err;
+    struct Join{
+      ThreadPool& p; std::exception_ptr& err;
+      ~Join(){
+	Active() = false;
+	std::unique_lock<std::mutex> lock(p.m);
+	p.done.wait(lock,[this](){return p.pending==0;});
+	err = std::exchange(p.error,nullptr);}
+    };
+    {
+      Join join{*this,err};
+      Active() = true;
+      fct(std::size_t(0));
+    }
+    if(err){std::rethrow_exception(err);}
+  }
+
+  ~ThreadPool(){
+    {
+      std::lock_guard<std::mutex> lock(m);
+      stop = true;
+    }
+    wake.notify_all();
+    for(auto& w:workers){w.join();}
+  }
+
+private:
+
+  ThreadPool() = default;
+
+  void loop(const std::size_t& id){
+    Active() = true;
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(m);
+    while(true){
+      wake.wait(lock,[&](){return stop || generation!=seen;});
+      if(stop){return;}
+      seen = generation;
+      if(id>=ntask){continue;}
+      auto c = call; void* x = ctx;
+      lock.unlock();
+      std::exception_ptr e;
+      try{c(x,id);}
+      catch(...){e = std::current_exception();}
+      lock.lock();
+      if(e && !error){error = e;}
+      if(--pending==0){done.notify_one();}
+    }
+  }
+
+  std::mutex                   busy, m;
+  std::condition_variable      wake, done;
+  std::vector<std::thread>     workers;
+  void (*call)(void*, const std::size_t&) = nullptr;
+  void*                        ctx        = nullptr;
+  std::size_t                  ntask      = 0;
+  std::size_t                  pending    = 0;
+  std::size_t                  generation = 0;
+  bool                         stop       = false;
+  std::exception_ptr           error;
+
+};
+
+
+//############################//
+//   Boucles multi-threads    //
+//############################//
+
+// Appelle fct(begin,end,t) sur des tranches contigues de [0,n),
+// la tranche t etant toujours la t-ieme dans l'ordre de [0,n).
+// Les boucles imbriquees dans une region parallele sont sequentielles.
+template <typename FctType>
+void ParallelRange(const std::size_t& n, FctType fct,
+		   const std::size_t& grain = 1024){
+
+  std::size_t nt = std::min(NbThread(),(n+grain-1)/grain);
+  if(nt<=1 || ThreadPool::Active()){
+    if(n>0){fct(std::size_t(0),n,std::size_t(0));}
+    return;}
+
+  auto work = [&](const std::size_t& t){
+    fct((t*n)/nt,((t+1)*n)/nt,t);};
+  ThreadPool::Get().run(nt,work);
+}
+
+template <typename FctType>
+void ParallelFor(const std::size_t& n, FctType fct,
+		 const std::size_t& grain = 1024){
+  ParallelRange(n,[&fct](const std::size_t& b,
+			 const std::size_t& e,
+			 const std::size_t&){
+    for(std::size_t j=b; j<e; ++j){fct(j);}},grain);
+}
+
+// Repartition dynamique de n taches de tailles heterogenes:
+// fct(j,t) avec t le numero du thread qui execute la tache j.
+template <typename FctType>
+void ParallelTasks(const std::size_t& n, FctType fct){
+
+  std::size_t nt = std::min(NbThread(),n);
+  std::atomic<std::size_t> next(0);
+  auto work = [&](const std::size_t& t){
+    for(std::size_t j=next++; j<n; j=next++){fct(j,t);}};
+
+  if(nt<=1 || ThreadPool::Active()){work(0); return;}
+  ThreadPool::Get().run(nt,work);
+}
+
+
+#endif
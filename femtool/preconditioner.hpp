@@ -14,21 +14,29 @@ public:
   using ThisType        = CholeskyPrec;  
   using EigenVectorType = Eigen::Matrix<ValueType,Eigen::Dynamic,1>;
   using EigenMatrixType = Eigen::SparseMatrix<ValueType>;
+  using EigenDenseType  = Eigen::Matrix<ValueType,Eigen::Dynamic,Eigen::Dynamic>;
   using ContainerType   = Eigen::IncompleteCholesky<ValueType>;
   
   CholeskyPrec(const CooMatrix<ValueType>& A):
     nr(NbRow(A)), nc(NbCol(A)),
     data_ptr(std::make_shared<ContainerType>()),
-    u_ptr(std::make_shared<EigenVectorType>()),
-    b_ptr(std::make_shared<EigenVectorType>())
+    stats_ptr(std::make_shared<FactorStatsData>())
   {
     assert( nr==nc );
+    using ClockType = FactorStatsData::ClockType;
+    auto& stats = stats_ptr->stats;
     Eigen::SparseMatrix<double> Ae(nr,nc);
     Copy(A,Ae);
+    auto t0 = ClockType::now();
     data_ptr->analyzePattern(Ae);
+    stats.t_analyze = FactorStatsData::Seconds(t0);
+    t0 = ClockType::now();
     data_ptr->factorize(Ae);
-    u_ptr->resize(nr);
-    b_ptr->resize(nc);
+    stats.t_factor = FactorStatsData::Seconds(t0);
+    stats.count = 1;
+    stats.n     = nr;
+    stats.nnzA  = Ae.nonZeros();
+    FactorCost(*data_ptr,stats);
   };
 
   CholeskyPrec()                               = default;
@@ -42,19 +50,52 @@ public:
   friend std::size_t
   NbCol(const ThisType& m){return m.nc;}
 
-  auto operator()(const std::vector<ValueType>& b) const {
+  friend FactorStats
+  Stats(const ThisType& m){
+    return m.stats_ptr ? m.stats_ptr->get() : FactorStats();}
 
-    auto& ue = *u_ptr;
-    auto& be = *b_ptr;
-    
-    Copy(b,be);
-    ue = data_ptr->solve(*b_ptr);
-    std::vector<ValueType> u;
-    Copy(ue,u);
-    
+  // Application reentrante (voir InvCooMatrix::solve)
+  void solve(const std::vector<ValueType>& b,
+	     std::vector<ValueType>& u) const {
+    assert(b.size()==nc);
+    auto t0 = FactorStatsData::ClockType::now();
+    u.resize(nr);
+    Eigen::Map<const EigenVectorType> be(b.data(),nc);
+    Eigen::Map<EigenVectorType>       ue(u.data(),nr);
+    ue = data_ptr->solve(be);
+    stats_ptr->solved(t0);
+  }
+
+  auto operator()(const std::vector<ValueType>& b) const {
+    std::vector<ValueType> u(nr);
+    solve(b,u);
     return u;
   }
 
+  template <typename MultiVectorType>
+  void solve(const MultiVectorType& B,
+	     MultiVectorType& X) const {
+    auto t0 = FactorStatsData::ClockType::now();
+    EigenDenseType Be, Xe;
+    Copy(B,Be);
+    assert(std::size_t(Be.rows())==nc);
+    Xe = data_ptr->solve(Be);
+    Copy(Xe,X);
+    stats_ptr->solved(t0);
+  }
+
+  auto operator()(const DenseMatrix<ValueType>& B) const {
+    DenseMatrix<ValueType> X;
+    solve(B,X);
+    return X;
+  }
+
+  auto operator()(const std::vector<std::vector<ValueType>>& B) const {
+    std::vector<std::vector<ValueType>> X;
+    solve(B,X);
+    return X;
+  }
+
   auto operator*(const std::vector<ValueType>& b) const {
     return (*this)(b);}
     
@@ -63,8 +104,7 @@ private:
   //Data members
   std::size_t                       nr,nc;
   std::shared_ptr<ContainerType> data_ptr;
-  std::shared_ptr<EigenVectorType>  u_ptr;
-  std::shared_ptr<EigenVectorType>  b_ptr;
+  std::shared_ptr<FactorStatsData> stats_ptr;
   
 };
 
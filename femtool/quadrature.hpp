@@ -0,0 +1,264 @@
+#ifndef QUADRATURE_HPP
+#define QUADRATURE_HPP
+
+#include <array>
+#include <vector>
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <assert.h>
+#include "parallel.hpp"
+#include "p1kernel.hpp"
+#include "geometry.hpp"
+#include "fematrix.hpp"
+
+//############################//
+//  Quadratures sur simplexes //
+//############################//
+
+// Points en coordonnees barycentriques, poids de somme 1:
+//   int_e f = |e| sum_q w_q f(x_q)
+template <std::size_t DIM>
+struct Quadrature{
+  std::size_t                                order;
+  std::vector<std::array<double,DIM+1>>      point;
+  std::vector<double>                       weight;
+
+  std::size_t size() const {return weight.size();}
+};
+
+// Regle la moins couteuse exacte pour les polynomes de degre
+// order (1D: Gauss-Legendre, 2D: Strang-Fix/Dunavant, 3D: Keast).
+// Les regles s'arretent a l'ordre 5: au-dela, assert.
+template <std::size_t DIM>
+Quadrature<DIM> QuadratureRule(const std::size_t& order = 2){
+
+  static_assert(DIM>=1 && DIM<=3);
+  Quadrature<DIM> Q;
+
+  // Orbites de points symetriques
+  auto add = [&Q](const std::array<double,DIM+1>& l, const double& w){
+    Q.point.push_back(l); Q.weight.push_back(w);};
+  auto add_all = [&add](std::array<double,DIM+1> l, const double& w){
+    std::sort(l.begin(),l.end());
+    do{add(l,w);}while(std::next_permutation(l.begin(),l.end()));};
+
+  if constexpr(DIM==1){
+    if(order<=1){
+      Q.order = 1; add({0.5,0.5},1.);}
+    else if(order<=3){
+      Q.order = 3;
+      const double a = 0.5+0.5/std::sqrt(3.);
+      add_all({a,1.-a},0.5);}
+    else{
+      assert(order<=5);
+      Q.order = 5;
+      const double a = 0.5+0.5*std::sqrt(0.6);
+      add({0.5,0.5},4./9.);
+      add_all({a,1.-a},5./18.);}
+  }
+
+  if constexpr(DIM==2){
+    if(order<=1){
+      Q.order = 1; add({1./3.,1./3.,1./3.},1.);}
+    else if(order<=2){
+      Q.order = 2; add_all({2./3.,1./6.,1./6.},1./3.);}
+    else if(order<=4){
+      Q.order = 4;
+      add_all({0.108103018168070,0.445948490915965,0.445948490915965},
+	      0.223381589678011);
+      add_all({0.816847572980459,0.091576213509771,0.091576213509771},
+	      0.109951743655322);}
+    else{
+      assert(order<=5);
+      Q.order = 5;
+      add({1./3.,1./3.,1./3.},0.225);
+      add_all({0.059715871789770,0.470142064105115,0.470142064105115},
+	      0.132394152788506);
+      add_all({0.797426985353087,0.101286507323456,0.101286507323456},
+	      0.125939180544827);}
+  }
+
+  if constexpr(DIM==3){
+    if(order<=1){
+      Q.order = 1; add({0.25,0.25,0.25,0.25},1.);}
+    else if(order<=2){
+      Q.order = 2;
+      const double a = 0.5854101966249685, b = 0.1381966011250105;
+      add_all({a,b,b,b},0.25);}
+    else if(order<=3){
+      Q.order = 3;
+      add({0.25,0.25,0.25,0.25},-0.8);
+      add_all({0.5,1./6.,1./6.,1./6.},0.45);}
+    else if(order<=4){
+      Q.order = 4;
+      const double a = 0.3994035761667992, b = 0.1005964238332008;
+      add({0.25,0.25,0.25,0.25},-0.0789333333333333);
+      add_all({11./14.,1./14.,1./14.,1./14.},0.0457333333333333);
+      add_all({a,a,b,b},0.1493333333333333);}
+    else{
+      assert(order<=5);
+      Q.order = 5;
+      const double a = 0.0665501535736643, b = 0.5-a;
+      add({0.25,0.25,0.25,0.25},0.1817020685825351);
+      add_all({0.,1./3.,1./3.,1./3.},0.0361607142857143);
+      add_all({8./11.,1./11.,1./11.,1./11.},0.0698714945161738);
+      add_all({a,a,b,b},0.0656948493683187);}
+  }
+
+  return Q;
+}
+
+
+//############################//
+//     Seconds membres        //
+//############################//
+
+// Assemblage simultane des vecteurs b_l[I] = int f_l phi_I.
+// Les fonctions sont evaluees par lots de P1Lanes*Q.size() points,
+// soit point par point f(x), soit par blocs f(x,v) (v[p] = f(x[p])).
+// Les contributions elementaires sont ajoutees directement dans b,
+// couleur par couleur (cf. Coloring): chaque ddl les recoit dans
+// l'ordre des couleurs, et le resultat ne depend pas du nombre de
+// threads. vol(elts,n,x,h) fournit les mesures d'un lot.
+template <std::size_t DIM, typename FctType, typename VolFctType>
+std::vector<std::vector<double>>
+Load(const FeSpace<DIM>& Vh,
+     const std::vector<std::vector<std::size_t>>& color,
+     const std::vector<FctType>& f,
+     const Quadrature<DIM>& Q,
+     VolFctType vol){
+
+  constexpr std::size_t d = FeSpace<DIM>::local_space_dim;
+  constexpr std::size_t W = P1Lanes;
+  const std::size_t nl = f.size();
+  const std::size_t nq = Q.size();
+
+  // Poids des fonctions de forme aux points de quadrature
+  std::vector<std::array<double,d>> wq(nq);
+  for(std::size_t q=0; q<nq; ++q){
+    for(std::size_t k=0; k<d; ++k){wq[q][k] = Q.weight[q]*Q.point[q][k];}}
+
+  std::vector<std::vector<double>> b(nl,std::vector<double>(dim(Vh),0.));
+  for(std::size_t c=0; c<color.size(); ++c){
+    const auto& elts = color[c];
+    auto work = [&](const std::size_t& l0,
+		    const std::size_t& l1,
+		    const std::size_t&){
+      P1Coords<DIM> x;
+      Lanes<W> h;
+      std::vector<R3>     pts(W*nq);
+      std::vector<double> val(W*nq);
+      for(std::size_t j0=l0; j0<l1; j0+=W){
+	std::size_t n = std::min(W,l1-j0);
+	P1Load<DIM>(Vh,elts.data()+j0,n,x);
+	vol(elts.data()+j0,n,x,h);
+
+	for(std::size_t q=0; q<nq; ++q){
+	  const auto& lq = Q.point[q];
+	  for(std::size_t r=0; r<3; ++r){
+	    for(std::size_t w=0; w<W; ++w){
+	      double y = 0.;
+	      for(std::size_t k=0; k<d; ++k){y += lq[k]*x[k][r][w];}
+	      pts[w*nq+q][r] = y;}}
+	}
+
+	for(std::size_t l=0; l<nl; ++l){
+	  const auto& fl = f[l];
+	  if constexpr(std::invocable<const FctType&,std::span<const R3>,
+			              std::span<double>>){
+	    fl(std::span<const R3>(pts.data(),n*nq),
+	       std::span<double>(val.data(),n*nq));}
+	  else{
+	    for(std::size_t p=0; p<n*nq; ++p){val[p] = fl(pts[p]);}}
+
+	  auto& bl = b[l];
+	  for(std::size_t w=0; w<n; ++w){
+	    std::array<double,d> be{};
+	    for(std::size_t q=0; q<nq; ++q){
+	      double v = val[w*nq+q];
+	      for(std::size_t k=0; k<d; ++k){be[k] += v*wq[q][k];}}
+	    const auto& I = Vh[elts[j0+w]];
+	    for(std::size_t k=0; k<d; ++k){bl[I[k]] += h[w]*be[k];}
+	  }
+	}
+      }
+    };
+    if(c<64){ParallelRange(elts.size(),work);}
+    else    {work(0,elts.size(),0);}
+  }
+
+  return b;
+}
+
+template <std::size_t DIM, typename FctType>
+std::vector<std::vector<double>>
+Load(const FeSpace<DIM>& Vh,
+     const std::vector<FctType>& f,
+     const Quadrature<DIM>& Q){
+  return Load(Vh,Coloring(Vh),f,Q,
+	      [](const std::size_t*, const std::size_t&,
+		 const P1Coords<DIM>& x, Lanes<P1Lanes>& h){
+		P1Volume<DIM>(x,h);});
+}
+
+// Meme chose avec les mesures lues dans le cache geo
+template <std::size_t DIM, typename FctType>
+std::vector<std::vector<double>>
+Load(const FeSpace<DIM>& Vh,
+     const Geometry<DIM>& geo,
+     const std::vector<FctType>& f,
+     const Quadrature<DIM>& Q){
+  assert(geo.size()==Vh.size());
+  const auto& v = GetData(geo).vol;
+  return Load(Vh,Coloring(Vh),f,Q,
+	      [&v](const std::size_t* elts, const std::size_t& n,
+		   const P1Coords<DIM>&, Lanes<P1Lanes>& h){
+		for(std::size_t w=0; w<P1Lanes; ++w){
+		  h[w] = v[elts[std::min(w,n-1)]];}});
+}
+
+template <std::size_t DIM, typename FctType>
+std::vector<std::vector<double>>
+Load(const FeSpace<DIM>& Vh,
+     const std::vector<FctType>& f,
+     const std::size_t& order = 2){
+  return Load(Vh,f,QuadratureRule<DIM>(order));}
+
+template <std::size_t DIM, typename FctType>
+std::vector<double> Load(const FeSpace<DIM>& Vh,
+			 const FctType& f,
+			 const Quadrature<DIM>& Q){
+  return Load(Vh,std::vector<FctType>{f},Q)[0];}
+
+template <std::size_t DIM, typename FctType>
+std::vector<double> Load(const FeSpace<DIM>& Vh,
+			 const FctType& f,
+			 const std::size_t& order = 2){
+  return Load(Vh,f,QuadratureRule<DIM>(order));}
+
+template <std::size_t DIM, typename FctType>
+std::vector<std::vector<double>>
+Load(const FeSpace<DIM>& Vh,
+     const Geometry<DIM>& geo,
+     const std::vector<FctType>& f,
+     const std::size_t& order = 2){
+  return Load(Vh,geo,f,QuadratureRule<DIM>(order));}
+
+template <std::size_t DIM, typename FctType>
+std::vector<double> Load(const FeSpace<DIM>& Vh,
+			 const Geometry<DIM>& geo,
+			 const FctType& f,
+			 const Quadrature<DIM>& Q){
+  return Load(Vh,geo,std::vector<FctType>{f},Q)[0];}
+
+template <std::size_t DIM, typename FctType>
+std::vector<double> Load(const FeSpace<DIM>& Vh,
+			 const Geometry<DIM>& geo,
+			 const FctType& f,
+			 const std::size_t& order = 2){
+  return Load(Vh,geo,f,QuadratureRule<DIM>(order));}
+
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef RENUMBERING_HPP
+#define RENUMBERING_HPP
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <tuple>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <assert.h>
+
+// Convention: une permutation perm verifie perm[nouveau] = ancien.
+
+enum class SpaceFillingCurve { Morton, Hilbert };
+
+
+//############################//
+//   Cles de courbe de Peano  //
+//############################//
+
+std::uint64_t
+HilbertKey(std::array<std::uint32_t,3> X,
+	   const std::size_t& n, const std::size_t& nbits){
+
+  // Algorithme de Skilling (AxesToTranspose)
+  std::uint32_t M = std::uint32_t(1) << (nbits-1);
+  for(std::uint32_t Q=M; Q>1; Q>>=1){
+    std::uint32_t P = Q-1;
+    for(std::size_t i=0; i<n; ++i){
+      if(X[i] & Q){X[0] ^= P;}
+      else{
+	std::uint32_t t = (X[0]^X[i]) & P;
+	X[0] ^= t; X[i] ^= t;}
+    }
+  }
+  for(std::size_t i=1; i<n; ++i){X[i] ^= X[i-1];}
+  std::uint32_t t = 0;
+  for(std::uint32_t Q=M; Q>1; Q>>=1){
+    if(X[n-1] & Q){t ^= Q-1;}}
+  for(std::size_t i=0; i<n; ++i){X[i] ^= t;}
+
+  // Entrelacement des bits
+  std::uint64_t key = 0;
+  for(std::size_t b=nbits; b-->0;){
+    for(std::size_t i=0; i<n; ++i){
+      key = (key<<1) | ((X[i]>>b) & 1u);}}
+  return key;
+}
+
+std::uint64_t
+MortonKey(const std::array<std::uint32_t,3>& X,
+	  const std::size_t& n, const std::size_t& nbits){
+  std::uint64_t key = 0;
+  for(std::size_t b=nbits; b-->0;){
+    for(std::size_t i=0; i<n; ++i){
+      key = (key<<1) | ((X[i]>>b) & 1u);}}
+  return key;
+}
+
+std::vector<std::uint64_t>
+SfcKeys(const std::vector<R3>& x,
+	const SpaceFillingCurve& curve = SpaceFillingCurve::Hilbert){
+
+  std::vector<std::uint64_t> key(x.size(),0);
+  if(x.empty()){return key;}
+
+  // Boite englobante
+  R3 xmin = x[0], xmax = x[0];
+  for(const auto& xj:x){
+    for(std::size_t k=0; k<3; ++k){
+      xmin[k] = std::min(xmin[k],xj[k]);
+      xmax[k] = std::max(xmax[k],xj[k]);}}
+
+  // Seules les directions non degenerees sont codees
+  std::array<std::size_t,3> axis;
+  std::size_t n = 0;
+  double h = 0.;
+  for(std::size_t k=0; k<3; ++k){h = std::max(h,xmax[k]-xmin[k]);}
+  for(std::size_t k=0; k<3; ++k){
+    if(xmax[k]-xmin[k]>1e-12*h){axis[n++]=k;}}
+  if(n==0){return key;}
+
+  std::size_t nbits = std::min<std::size_t>(63/n,32);
+  double scale = std::ldexp(1.,int(nbits))-1.;
+  std::array<std::uint32_t,3> X;
+  X.fill(0);
+  for(std::size_t j=0; j<x.size(); ++j){
+    for(std::size_t i=0; i<n; ++i){
+      std::size_t k = axis[i];
+      X[i] = std::uint32_t(scale*(x[j][k]-xmin[k])/h);}
+    key[j] = (curve==SpaceFillingCurve::Hilbert ?
+	      HilbertKey(X,n,nbits) : MortonKey(X,n,nbits));
+  }
+  return key;
+}
+
+std::vector<std::size_t>
+SfcOrder(const std::vector<R3>& x,
+	 const SpaceFillingCurve& curve = SpaceFillingCurve::Hilbert){
+
+  auto key = SfcKeys(x,curve);
+  std::vector<std::tuple<std::uint64_t,std::size_t>> tbl(x.size());
+  for(std::size_t j=0; j<x.size(); ++j){
+    tbl[j] = {key[j],j};}
+  std::sort(tbl.begin(),tbl.end());
+
+  std::vector<std::size_t> perm(x.size());
+  for(std::size_t j=0; j<x.size(); ++j){
+    perm[j] = std::get<1>(tbl[j]);}
+  return perm;
+}
+
+
+//############################//
+//  Application permutations  //
+//############################//
+
+std::vector<std::size_t>
+Inverse(const std::vector<std::size_t>& perm){
+  std::vector<std::size_t> iperm(perm.size());
+  for(std::size_t j=0; j<perm.size(); ++j){
+    iperm[perm[j]] = j;}
+  return iperm;
+}
+
+template <typename T>
+std::vector<T> Permute(const std::vector<T>& u,
+		       const std::vector<std::size_t>& perm){
+  assert(u.size()==perm.size());
+  std::vector<T> v(u.size());
+  for(std::size_t j=0; j<perm.size(); ++j){
+    v[j] = u[perm[j]];}
+  return v;
+}
+
+template <typename T>
+std::vector<T> Unpermute(const std::vector<T>& v,
+			 const std::vector<std::size_t>& perm){
+  assert(v.size()==perm.size());
+  std::vector<T> u(v.size());
+  for(std::size_t j=0; j<perm.size(); ++j){
+    u[perm[j]] = v[j];}
+  return u;
+}
+
+// Matrice renumerotee B[j,k] = A[perm[j],perm[k]]
+template <typename ValueType>
+CooMatrix<ValueType> Permute(const CooMatrix<ValueType>& A,
+			     const std::vector<std::size_t>& perm){
+  assert(NbRow(A)==perm.size() && NbCol(A)==perm.size());
+  auto iperm = Inverse(perm);
+  CooMatrix<ValueType> B(NbRow(A),NbCol(A));
+  B.reserve(GetData(A).size());
+  for(const auto& [j,k,v]:A){
+    B.push_back(iperm[j],iperm[k],v);}
+  B.sort();
+  return B;
+}
+
+// Espace dont le ddl j est le ddl perm[j] de Vh
+template <std::size_t DIM>
+FeSpace<DIM> Permute(const FeSpace<DIM>& Vh,
+		     const std::vector<std::size_t>& perm){
+  assert(dim(Vh)==perm.size());
+  const auto v = Vh.nodes();
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  // Sommet porte par chaque ddl
+  std::vector<std::size_t> vtx(dim(Vh));
+  for(const auto& I:Vh){
+    for(std::size_t k=0; k<I.size(); ++k){
+      vtx[I[k]] = v.index(I.elt()[k]);}}
+
+  // Ordre des sommets: ceux portant un ddl, puis les autres
+  std::vector<std::size_t> vperm, mark(v.size(),npos);
+  vperm.reserve(v.size());
+  for(const auto& j:perm){
+    vperm.push_back(vtx[j]);
+    mark[vtx[j]] = 0;}
+  for(std::size_t I=0; I<v.size(); ++I){
+    if(mark[I]==npos){vperm.push_back(I);}}
+
+  return FeSpace<DIM>(Vh.mesh(),vperm);
+}
+
+
+//############################//
+//  Renumerotation maillage   //
+//############################//
+
+template <std::size_t DIM>
+auto Renumber(const Mesh<DIM>& m,
+	      const SpaceFillingCurve& curve = SpaceFillingCurve::Hilbert){
+
+  const auto v = m.nodes();
+
+  // Ordre des noeuds
+  auto vperm  = SfcOrder(v.data(),curve);
+  auto ivperm = Inverse(vperm);
+
+  Nodes new_v;
+  new_v.reserve(v.size());
+  for(const auto& j:vperm){new_v.push_back(v[j]);}
+
+  // Ordre des elements
+  std::vector<R3> ctr(m.size());
+  for(std::size_t j=0; j<m.size(); ++j){
+    ctr[j] = Ctr(m[j]);}
+  auto eperm = SfcOrder(ctr,curve);
+
+  Mesh<DIM> new_m(new_v);
+  new_m.reserve(m.size());
+  Element<DIM> e;
+  for(const auto& j:eperm){
+    for(std::size_t k=0; k<DIM+1; ++k){
+      e.push_back(new_v[ivperm[v.index(m[j][k])]]);}
+    new_m.push_back(e);
+    e.clear();
+  }
+
+  return std::make_tuple(new_m,vperm,eperm);
+}
+
+
+#endif
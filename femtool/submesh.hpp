@@ -0,0 +1,101 @@
+#ifndef SUBMESH_HPP
+#define SUBMESH_HPP
+
+#include <vector>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+#include "parallel.hpp"
+
+//############################//
+//  Extraction sous-maillage  //
+//############################//
+
+// Le tableau marker (taille m.nodes().size(), rempli de npos)
+// est restitue dans son etat initial: le cout est lineaire
+// en la taille du sous-maillage.
+template <std::size_t DIM>
+auto SubMesh(const Mesh<DIM>& m,
+	     const std::vector<std::size_t>& elts,
+	     std::vector<std::size_t>& marker){
+
+  constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  const auto v = m.nodes();
+  assert(marker.size()==v.size());
+
+  // Numerotation locale des sommets (ordre de premiere apparition)
+  std::vector<std::size_t> vtx;
+  vtx.reserve(elts.size()+DIM+1);
+  for(const auto& j:elts){
+    for(std::size_t k=0; k<DIM+1; ++k){
+      std::size_t I = v.index(m[j][k]);
+      if(marker[I]==npos){
+	marker[I] = vtx.size();
+	vtx.push_back(I);}
+    }
+  }
+
+  Nodes sub_v;
+  sub_v.reserve(vtx.size());
+  for(const auto& I:vtx){sub_v.push_back(v[I]);}
+
+  Mesh<DIM> sub_m(sub_v);
+  sub_m.reserve(elts.size());
+  Element<DIM> e;
+  for(const auto& j:elts){
+    for(std::size_t k=0; k<DIM+1; ++k){
+      e.push_back(sub_v[marker[v.index(m[j][k])]]);}
+    sub_m.push_back(e);
+    e.clear();
+  }
+
+  for(const auto& I:vtx){marker[I] = npos;}
+
+  return std::make_tuple(sub_m,vtx,elts);
+}
+
+template <std::size_t DIM>
+auto SubMesh(const Mesh<DIM>& m,
+	     const std::vector<std::size_t>& elts){
+  std::vector<std::size_t> marker(m.nodes().size(),
+				  std::numeric_limits<std::size_t>::max());
+  return SubMesh(m,elts,marker);
+}
+
+// Extraction simultanee de plusieurs sous-domaines
+template <std::size_t DIM>
+auto SubMesh(const Mesh<DIM>& m,
+	     const std::vector<std::vector<std::size_t>>& parts){
+
+  using SubMeshType = std::tuple<Mesh<DIM>,
+				 std::vector<std::size_t>,
+				 std::vector<std::size_t>>;
+  std::vector<SubMeshType> sub(parts.size());
+  std::vector<std::vector<std::size_t>> marker(NbThread());
+
+  ParallelTasks(parts.size(),
+		[&](const std::size_t& p, const std::size_t& t){
+		  if(marker[t].empty()){
+		    marker[t].assign(m.nodes().size(),
+				     std::numeric_limits<std::size_t>::max());}
+		  sub[p] = SubMesh(m,parts[p],marker[t]);
+		});
+  return sub;
+}
+
+// Listes d'elements par sous-domaine a partir de la matrice
+// booleenne (element,sous-domaine) renvoyee par Partition4
+std::vector<std::vector<std::size_t>>
+PartitionLists(const CooMatrix<double>& Q){
+
+  std::vector<std::vector<std::size_t>> parts(NbCol(Q));
+  for(const auto& [e,p,v]:Q){
+    if(v!=0.){parts[p].push_back(e);}}
+  for(auto& part:parts){
+    std::sort(part.begin(),part.end());
+    part.erase(std::unique(part.begin(),part.end()),part.end());}
+  return parts;
+}
+
+
+#endif
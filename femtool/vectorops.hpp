@@ -14,14 +14,14 @@ std::ostream& operator<<(std::ostream& o,
 
 template <typename T,typename S>
 auto& operator+=(std::vector<T>& x,
-		const std::vector<S> y){
+		const std::vector<S>& y){
   assert(x.size() == y.size() );
   for(std::size_t j=0; j<x.size(); ++j){x[j]+=y[j];}
   return x;}
 
 template <typename T,typename S>
 auto& operator-=(std::vector<T>& x,
-		const std::vector<S> y){
+		const std::vector<S>& y){
   assert(x.size() == y.size() );
   for(std::size_t j=0; j<x.size(); ++j){x[j]-=y[j];}
   return x;}